@@ -13,7 +13,23 @@ void devote_generate_vote(
     NSMutableData * const proof_out,
     NSMutableData * const pinput_out,
     NSMutableData * const ct_out,
-    NSMutableData * const sn_out);
+    NSMutableData * const sn_out,
+    size_t check_level);
+
+void devote_generate_vote_from_copath(
+    size_t tree_depth, size_t voter_idx, size_t vote,
+    const NSData * const copath,
+    const NSData * const rt,
+    const NSData * const eid,
+    const NSData * const sk,
+    const NSData * const pk_eid,
+    const NSData * const proving_key,
+    const NSData * const verification_key,
+    NSMutableData * const proof_out,
+    NSMutableData * const pinput_out,
+    NSMutableData * const ct_out,
+    NSMutableData * const sn_out,
+    size_t check_level);
 
 bool devote_verify_tally(
     size_t tree_depth,
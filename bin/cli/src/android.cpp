@@ -96,7 +96,8 @@ Java_com_devote_DeVoteJNI_generateVote(JNIEnv *env, jobject thiz, jint tree_dept
                        jbyteArray r1cs_verification_key_buffer,
                        jbyteArray proof_buffer_out,
                        jbyteArray pinput_buffer_out,
-                       jbyteArray ct_buffer_out, jbyteArray sn_buffer_out) {
+                       jbyteArray ct_buffer_out, jbyteArray sn_buffer_out,
+                       jint check_level) {
     std::vector<std::uint8_t> proof_blob_out;
     std::vector<std::uint8_t> pinput_blob_out;
     std::vector<std::uint8_t> ct_blob_out;
@@ -113,7 +114,46 @@ Java_com_devote_DeVoteJNI_generateVote(JNIEnv *env, jobject thiz, jint tree_dept
     process_encrypted_input_mode_vote_phase(tree_depth, eid_bits, voter_idx, vote, merkle_tree_blob,
                                             rt_blob, eid_blob, sk_blob, pk_eid_blob, proving_key_blob,
                                             verification_key_blob,
-                                            proof_blob_out, pinput_blob_out, ct_blob_out, sn_blob_out);
+                                            proof_blob_out, pinput_blob_out, ct_blob_out, sn_blob_out,
+                                            static_cast<witness_check_level>(check_level));
+
+    write_to_buffer(env, proof_blob_out, proof_buffer_out);
+    write_to_buffer(env, pinput_blob_out, pinput_buffer_out);
+    write_to_buffer(env, ct_blob_out, ct_buffer_out);
+    write_to_buffer(env, sn_blob_out, sn_buffer_out);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_devote_DeVoteJNI_generateVoteFromCopath(JNIEnv *env, jobject thiz, jint tree_depth,
+                       jint eid_bits, jint voter_idx, jint vote,
+                       jbyteArray copath_buffer, jbyteArray rt_buffer,
+                       jbyteArray eid_buffer, jbyteArray sk_buffer,
+                       jbyteArray pk_eid_buffer,
+                       jbyteArray r1cs_proving_key_buffer,
+                       jbyteArray r1cs_verification_key_buffer,
+                       jbyteArray proof_buffer_out,
+                       jbyteArray pinput_buffer_out,
+                       jbyteArray ct_buffer_out, jbyteArray sn_buffer_out,
+                       jint check_level) {
+    std::vector<std::uint8_t> proof_blob_out;
+    std::vector<std::uint8_t> pinput_blob_out;
+    std::vector<std::uint8_t> ct_blob_out;
+    std::vector<std::uint8_t> sn_blob_out;
+
+    auto copath_blob = read_buffer(env, copath_buffer);
+    auto rt_blob = read_buffer(env, rt_buffer);
+    auto eid_blob = read_buffer(env, eid_buffer);
+    auto sk_blob = read_buffer(env, sk_buffer);
+    auto pk_eid_blob = read_buffer(env, pk_eid_buffer);
+    auto proving_key_blob = read_buffer(env, r1cs_proving_key_buffer);
+    auto verification_key_blob = read_buffer(env, r1cs_verification_key_buffer);
+
+    process_encrypted_input_mode_vote_phase_copath(tree_depth, eid_bits, voter_idx, vote, copath_blob,
+                                                   rt_blob, eid_blob, sk_blob, pk_eid_blob, proving_key_blob,
+                                                   verification_key_blob,
+                                                   proof_blob_out, pinput_blob_out, ct_blob_out, sn_blob_out,
+                                                   static_cast<witness_check_level>(check_level));
 
     write_to_buffer(env, proof_blob_out, proof_buffer_out);
     write_to_buffer(env, pinput_blob_out, pinput_buffer_out);
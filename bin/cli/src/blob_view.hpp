@@ -0,0 +1,71 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2022 Noam Y <@NoamDev>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+#ifndef DEVOTE_BLOB_VIEW_HPP
+#define DEVOTE_BLOB_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Non-owning view of a serialized blob. Deserialization reads blobs through it, so they can come from a std::vector
+// as well as from memory the blob was never copied out of, e.g. a memory-mapped file. The memory should outlive the
+// view.
+class blob_view {
+public:
+    using value_type = std::uint8_t;
+    using size_type = std::size_t;
+    using const_iterator = const std::uint8_t *;
+    using iterator = const_iterator;
+
+    blob_view() = default;
+
+    blob_view(const std::uint8_t *data, std::size_t size) : blob_data(data), blob_size(size) {
+    }
+
+    blob_view(const std::vector<std::uint8_t> &blob) : blob_data(blob.data()), blob_size(blob.size()) {
+    }
+
+    const_iterator begin() const {
+        return blob_data;
+    }
+
+    const_iterator end() const {
+        return blob_data + blob_size;
+    }
+
+    const std::uint8_t *data() const {
+        return blob_data;
+    }
+
+    std::size_t size() const {
+        return blob_size;
+    }
+
+    bool empty() const {
+        return blob_size == 0;
+    }
+
+    std::uint8_t operator[](std::size_t i) const {
+        return blob_data[i];
+    }
+
+private:
+    const std::uint8_t *blob_data = nullptr;
+    std::size_t blob_size = 0;
+};
+
+#endif    // DEVOTE_BLOB_VIEW_HPP
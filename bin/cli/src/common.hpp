@@ -19,15 +19,38 @@
 #define BOOST_ENABLE_ASSERT_HANDLER
 #include <boost/assert.hpp>
 
+#include "blob_view.hpp"
+#include "digest.hpp"
+
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <functional>
 #include <ctime>
+#include <chrono>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <tuple>
+#include <algorithm>
+#include <optional>
+#include <numeric>
 
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 
+#ifdef MULTICORE
+#include <omp.h>
+#endif
+
+#ifdef CRS_STORE_ON_DISK
+#include <filesystem>
+#endif
+
 #include <nil/crypto3/zk/components/voting/encrypted_input_voting.hpp>
 
 #include <nil/crypto3/algebra/curves/bls12.hpp>
@@ -68,6 +91,9 @@
 
 #include <nil/crypto3/random/algebraic_random_device.hpp>
 
+#include <nil/crypto3/hash/algorithm/hash.hpp>
+#include <nil/crypto3/hash/sha2.hpp>
+
 #include <nil/crypto3/detail/pack.hpp>
 
 using namespace nil::crypto3;
@@ -145,6 +171,51 @@ inline void logln(Args && ...args)
 #endif
 }
 
+#ifdef MULTICORE
+// OpenMP thread count the process started with, one per core unless OMP_NUM_THREADS says otherwise.
+int default_prover_threads() {
+    static const int threads = omp_get_max_threads();
+    return threads;
+}
+#endif
+
+// Same as set_prover_threads, without the report. OpenMP keeps the thread count per thread, so threads started with
+// std::thread have to call it themselves.
+void set_current_thread_prover_threads(std::size_t threads) {
+#ifdef MULTICORE
+    omp_set_num_threads(threads > 0 ? static_cast<int>(threads) : default_prover_threads());
+#endif
+}
+
+// Sets the number of threads the Groth16 prover uses for its multi-scalar multiplications and FFTs. These are
+// parallelized with OpenMP inside crypto3 in MULTICORE builds only, otherwise the call has no effect. It applies to the calling thread, zero restoring
+// the thread count the process started with.
+void set_prover_threads(std::size_t threads) {
+#ifdef MULTICORE
+    default_prover_threads();
+    set_current_thread_prover_threads(threads);
+    logln("Prover uses " , omp_get_max_threads() , " threads" );
+#else
+    if (threads > 1) {
+        logln("Built without MULTICORE, prover runs single-threaded" );
+    }
+#endif
+}
+
+// Milliseconds since the stopwatch was started, for progress reports of the long running steps.
+class stopwatch {
+public:
+    stopwatch() : start(std::chrono::steady_clock::now()) {
+    }
+
+    long long elapsed_ms() const {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
 struct encrypted_input_policy {
     using pairing_curve_type = curves::bls12_381;
     using curve_type = curves::jubjub;
@@ -164,6 +235,9 @@ struct encrypted_input_policy {
     static constexpr std::size_t msg_size = 25;
     static constexpr std::size_t secret_key_bits = hash_type::digest_bits;
     static constexpr std::size_t public_key_bits = secret_key_bits;
+    using secret_key_type = digest<secret_key_bits>;
+    using public_key_type = digest<public_key_bits>;
+    using merkle_node_type = digest<merkle_hash_type::digest_bits>;
 };
 
 struct marshaling_policy {
@@ -203,12 +277,21 @@ struct marshaling_policy {
     nil::crypto3::marshalling::types::r1cs_gg_ppzksnark_primary_input<nil::marshalling::field_type<endianness>,
     primary_input_type>;
 
+    // Serializers take the fill/make function of the marshalling type as is, so the call is resolved and inlined at
+    // compile time. Serializing into a caller's blob reuses its capacity, a blob kept across ballots is allocated once.
     template<typename MarshalingType, typename InputObj, typename F>
-    static std::vector<std::uint8_t> serialize_obj(const InputObj &in_obj, const std::function<F> &f) {
+    static void serialize_obj(const InputObj &in_obj, F &&f, std::vector<std::uint8_t> &blob) {
         MarshalingType filled_val = f(in_obj);
-        std::vector<std::uint8_t> blob(filled_val.length());
-        auto it = std::begin(blob);
+        blob.resize(filled_val.length());
+        auto it = blob.begin();
         nil::marshalling::status_type status = filled_val.write(it, blob.size());
+        BOOST_ASSERT_MSG(status == nil::marshalling::status_type::success, "Object serialization failed!");
+    }
+
+    template<typename MarshalingType, typename InputObj, typename F>
+    static std::vector<std::uint8_t> serialize_obj(const InputObj &in_obj, F &&f) {
+        std::vector<std::uint8_t> blob;
+        serialize_obj<MarshalingType>(in_obj, std::forward<F>(f), blob);
         return blob;
     }
 
@@ -227,11 +310,22 @@ struct marshaling_policy {
     //     out.close();
     // }
 
+    // Blobs of untrusted origin should be read with status: a blob which is truncated, or longer than the object it
+    // holds, sets it to an error and gives a default-constructed object instead of a partially read one.
     template<typename MarshalingType, typename ReturnType, typename InputBlob, typename F>
-    static ReturnType deserialize_obj(const InputBlob &blob, const std::function<F> &f) {
+    static ReturnType deserialize_obj(const InputBlob &blob, F &&f, nil::marshalling::status_type *status = nullptr) {
         MarshalingType marshaling_obj;
         auto it = std::cbegin(blob);
-        nil::marshalling::status_type status = marshaling_obj.read(it, blob.size());
+        nil::marshalling::status_type read_status = marshaling_obj.read(it, blob.size());
+        if (read_status == nil::marshalling::status_type::success && it != std::cend(blob)) {
+            read_status = nil::marshalling::status_type::invalid_msg_data;
+        }
+        if (status != nullptr) {
+            *status = read_status;
+            if (read_status != nil::marshalling::status_type::success) {
+                return ReturnType();
+            }
+        }
         return f(marshaling_obj);
     }
 
@@ -266,12 +360,12 @@ struct marshaling_policy {
     //     }
     // }
 
-    static void serialize_initial_phase_voter_data(const std::array<bool, encrypted_input_policy::public_key_bits> &voter_pubkey,
-                                                   const std::array<bool, encrypted_input_policy::secret_key_bits> &voter_skey,
+    static void serialize_initial_phase_voter_data(const encrypted_input_policy::public_key_type &voter_pubkey,
+                                                   const encrypted_input_policy::secret_key_type &voter_skey,
                                                    std::vector<std::uint8_t> &voter_pk_out,
                                                    std::vector<std::uint8_t> &voter_sk_out) {
-        voter_pk_out = serialize_bitarray<encrypted_input_policy::public_key_bits>(voter_pubkey);
-        voter_sk_out = serialize_bitarray<encrypted_input_policy::secret_key_bits>(voter_skey);
+        voter_pk_out = voter_pubkey.blob();
+        voter_sk_out = voter_skey.blob();
     }
 
     // static void write_initial_phase_admin_data(
@@ -341,48 +435,75 @@ struct marshaling_policy {
             std::vector<std::uint8_t> &r1cs_proving_key_out,
             std::vector<std::uint8_t> &r1cs_verification_key_out, std::vector<std::uint8_t> &public_key_output,
             std::vector<std::uint8_t> &secret_key_output, std::vector<std::uint8_t> &verification_key_output) {
+        serialize_crs(pk_crs, vk_crs, r1cs_proving_key_out, r1cs_verification_key_out);
+        serialize_elgamal_keys(pk_eid, sk_eid, vk_eid, public_key_output, secret_key_output, verification_key_output);
+    }
+
+    static void serialize_crs(const proving_key_type &pk_crs, const verification_key_type &vk_crs,
+                              std::vector<std::uint8_t> &r1cs_proving_key_out,
+                              std::vector<std::uint8_t> &r1cs_verification_key_out) {
         r1cs_proving_key_out = serialize_obj<r1cs_proving_key_marshalling_type>(
                 pk_crs,
-                std::function(
-                        nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_fast_proving_key<proving_key_type, endianness>));
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_fast_proving_key<proving_key_type, endianness>);
 
         r1cs_verification_key_out = serialize_obj<r1cs_verification_key_marshaling_type>(
                 vk_crs,
-                std::function(
-                        nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_verification_key<verification_key_type,
-                        endianness>));
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_verification_key<verification_key_type,
+                        endianness>);
+    }
 
+    static void serialize_elgamal_keys(const elgamal_public_key_type &pk_eid, const elgamal_private_key_type &sk_eid,
+                                       const elgamal_verification_key_type &vk_eid,
+                                       std::vector<std::uint8_t> &public_key_output,
+                                       std::vector<std::uint8_t> &secret_key_output,
+                                       std::vector<std::uint8_t> &verification_key_output) {
         public_key_output = serialize_obj<public_key_marshaling_type>(
                 pk_eid,
-                std::function(nil::crypto3::marshalling::types::fill_public_key<elgamal_public_key_type, endianness>));
+                nil::crypto3::marshalling::types::fill_public_key<elgamal_public_key_type, endianness>);
 
         secret_key_output = serialize_obj<secret_key_marshaling_type>(
                 sk_eid,
-                std::function(nil::crypto3::marshalling::types::fill_private_key<elgamal_private_key_type, endianness>));
+                nil::crypto3::marshalling::types::fill_private_key<elgamal_private_key_type, endianness>);
 
         verification_key_output = serialize_obj<verification_key_marshaling_type>(
                 vk_eid,
-                std::function(
-                        nil::crypto3::marshalling::types::fill_verification_key<elgamal_verification_key_type, endianness>));
+                nil::crypto3::marshalling::types::fill_verification_key<elgamal_verification_key_type, endianness>);
     }
 
     static void serialize_initial_phase_admin_data(
             const primary_input_type &eid, const primary_input_type &rt,
-            const std::vector<std::array<bool, encrypted_input_policy::merkle_hash_type::digest_bits>> &merkle_tree_hashes,
+            const std::vector<encrypted_input_policy::merkle_node_type> &merkle_tree_hashes,
             std::vector<std::uint8_t> &eid_output, std::vector<std::uint8_t> &rt_output,
             std::vector<std::uint8_t> &merkle_tree_output) {        
+        std::vector<std::uint8_t> merkle_tree_blob;
+        merkle_tree_blob.reserve(merkle_tree_hashes.size() * encrypted_input_policy::merkle_node_type::octets);
+        for (const auto &hash : merkle_tree_hashes) {
+            merkle_tree_blob.insert(merkle_tree_blob.end(), hash.data(),
+                                    hash.data() + encrypted_input_policy::merkle_node_type::octets);
+        }
+        serialize_initial_phase_admin_data(eid, rt, std::move(merkle_tree_blob), eid_output, rt_output,
+                                           merkle_tree_output);
+    }
+
+    // Same as above for a Merkle tree which is already serialized, e.g. by make_merkle_tree_blob.
+    static void serialize_initial_phase_admin_data(
+            const primary_input_type &eid, const primary_input_type &rt,
+            std::vector<std::uint8_t> &&merkle_tree_blob,
+            std::vector<std::uint8_t> &eid_output, std::vector<std::uint8_t> &rt_output,
+            std::vector<std::uint8_t> &merkle_tree_output) {
         eid_output = serialize_obj<pinput_marshaling_type>(
                 eid,
-                std::function(nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<primary_input_type,
-                              endianness>));
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<primary_input_type,
+                        endianness>);
 
         rt_output = serialize_obj<pinput_marshaling_type>(
                 rt,
-                std::function(nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<primary_input_type,
-                              endianness>));
-        for(auto hash : merkle_tree_hashes){
-            auto hash_blob = serialize_bitarray<encrypted_input_policy::merkle_hash_type::digest_bits>(hash);
-            merkle_tree_output.insert(merkle_tree_output.end(), hash_blob.begin(), hash_blob.end());
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<primary_input_type,
+                        endianness>);
+        if (merkle_tree_output.empty()) {
+            merkle_tree_output = std::move(merkle_tree_blob);
+        } else {
+            merkle_tree_output.insert(merkle_tree_output.end(), merkle_tree_blob.begin(), merkle_tree_blob.end());
         }
     }
 
@@ -461,24 +582,36 @@ struct marshaling_policy {
                                std::vector<std::uint8_t> &proof_blob,
                                std::vector<std::uint8_t> &pinput_blob, std::vector<std::uint8_t> &ct_blob,
                                std::vector<std::uint8_t> &sn_blob) {
-        proof_blob = serialize_obj<r1cs_proof_marshaling_type>(
+        serialize_obj<r1cs_proof_marshaling_type>(
                 proof,
-                std::function(nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_proof<proof_type, endianness>));
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_proof<proof_type, endianness>,
+                proof_blob);
 
-        pinput_blob = serialize_obj<pinput_marshaling_type>(
+        serialize_obj<pinput_marshaling_type>(
                 pinput,
-                std::function(nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<primary_input_type,
-                              endianness>));
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<primary_input_type,
+                        endianness>,
+                pinput_blob);
 
-        ct_blob = serialize_obj<ct_marshaling_type>(
+        serialize_obj<ct_marshaling_type>(
                 ct,
-                std::function(nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_encrypted_primary_input<
-                              encrypted_input_policy::encryption_scheme_type::cipher_type::first_type, endianness>));
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_encrypted_primary_input<
+                        encrypted_input_policy::encryption_scheme_type::cipher_type::first_type, endianness>,
+                ct_blob);
 
-        sn_blob = serialize_obj<pinput_marshaling_type>(
+        serialize_obj<pinput_marshaling_type>(
                 sn,
-                std::function(nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<primary_input_type,
-                              endianness>));
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<primary_input_type,
+                        endianness>,
+                sn_blob);
+    }
+
+    static std::vector<std::uint8_t>
+    serialize_ct(const encrypted_input_policy::encryption_scheme_type::cipher_type::first_type &ct) {
+        return serialize_obj<ct_marshaling_type>(
+                ct,
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_encrypted_primary_input<
+                        encrypted_input_policy::encryption_scheme_type::cipher_type::first_type, endianness>);
     }
 
     // static void
@@ -514,8 +647,8 @@ struct marshaling_policy {
 
         voting_res_blob = serialize_obj<pinput_marshaling_type>(
                 dec.first,
-                std::function(nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<
-                              std::vector<scalar_field_value_type>, endianness>));
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<
+                        std::vector<scalar_field_value_type>, endianness>);
     }
 
     // static std::vector<scalar_field_value_type> read_scalar_vector(const std::string &file_prefix) {
@@ -523,11 +656,20 @@ struct marshaling_policy {
     //     return deserialize_scalar_vector(read_obj(filename));
     // }
 
-    static std::vector<scalar_field_value_type> deserialize_scalar_vector(const std::vector<std::uint8_t> &blob) {
+    static std::vector<std::uint8_t> serialize_scalar_vector(const std::vector<scalar_field_value_type> &scalars) {
+        return serialize_obj<pinput_marshaling_type>(
+                scalars,
+                nil::crypto3::marshalling::types::fill_r1cs_gg_ppzksnark_primary_input<
+                        std::vector<scalar_field_value_type>, endianness>);
+    }
+
+    static std::vector<scalar_field_value_type> deserialize_scalar_vector(
+            blob_view blob, nil::marshalling::status_type *status = nullptr) {
         return deserialize_obj<pinput_marshaling_type, std::vector<scalar_field_value_type>>(
                 blob,
-                        std::function(nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_primary_input<
-                                      std::vector<scalar_field_value_type>, endianness>));
+                nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_primary_input<
+                        std::vector<scalar_field_value_type>, endianness>,
+                status);
     }
 
     // static std::vector<bool> read_bool_vector(const std::string &file_prefix) {
@@ -535,7 +677,7 @@ struct marshaling_policy {
     //     return deserialize_bool_vector(read_obj(filename));
     // }
 
-    static std::vector<bool> deserialize_bool_vector(const std::vector<std::uint8_t> &blob) {
+    static std::vector<bool> deserialize_bool_vector(blob_view blob) {
         std::vector<bool> result;
         for (const auto &i : deserialize_scalar_vector(blob)) {
             result.emplace_back(i.data);
@@ -543,19 +685,26 @@ struct marshaling_policy {
         return result;
     }
 
+    // Bits are little-endian, bits[i] being the coefficient of 2^i. They are gathered into 64-bit words, and the
+    // words into the integral value of the element, instead of doubling a field element once per bit.
     static scalar_field_value_type get_field_element_from_bits(const std::vector<bool> &bits) {
         BOOST_ASSERT(bits.size() < encrypted_input_policy::field_type::value_bits);
-        scalar_field_value_type result = scalar_field_value_type::zero();
-
-        for (std::size_t i = 0; i < bits.size(); ++i) {
-            /* push in the new bit */
-            const scalar_field_value_type v = (bits[bits.size() - 1 - i] ?
-                                               scalar_field_value_type::one() :
-                                               scalar_field_value_type::zero());
-            result = result + (result + v);
+        using integral_type = typename encrypted_input_policy::field_type::integral_type;
+        constexpr std::size_t word_bits = 64;
+
+        integral_type result = 0;
+        std::size_t words_number = (bits.size() + word_bits - 1) / word_bits;
+        for (std::size_t word_idx = words_number; word_idx-- > 0;) {
+            std::uint64_t word = 0;
+            std::size_t word_end = std::min(bits.size(), (word_idx + 1) * word_bits);
+            for (std::size_t i = word_end; i-- > word_idx * word_bits;) {
+                word = (word << 1) | std::uint64_t(bits[i]);
+            }
+            result <<= word_bits;
+            result |= integral_type(word);
         }
 
-        return result;
+        return scalar_field_value_type(result);
     }
 
     static std::vector<scalar_field_value_type> get_multi_field_element_from_bits(const std::vector<bool> &bits) {
@@ -571,38 +720,45 @@ struct marshaling_policy {
         return result;
     }
 
+    // Bits are packed most significant first, bitarray[0] going to the top bit of the first octet, as
+    // detail::pack with big_octet_big_bit does. Octets are filled eight bits at a time, without widening every bit
+    // to an octet first.
     template<int bits>
     static std::vector<std::uint8_t> serialize_bitarray(const std::array<bool, bits> &bitarray) {
 
         constexpr int octets = bits/8 + (bits%8 ? 1 : 0);
-        constexpr int bits_ceil = octets*8;
-
-        std::array<std::uint8_t, bits_ceil> in {};
-        std::copy_n(bitarray.begin(), bits, in.begin());
-
-        std::array<std::uint8_t, octets> out {};
-        nil::crypto3::detail::pack<nil::crypto3::stream_endian::big_octet_big_bit, nil::crypto3::stream_endian::big_octet_big_bit, 1, 8>(in.begin(), in.end(), out.begin());
 
-        std::vector<std::uint8_t> res;
-        std::copy(out.begin(), out.end(), std::back_inserter(res));
+        std::vector<std::uint8_t> res(octets, 0);
+        for (int octet_idx = 0; octet_idx < octets; ++octet_idx) {
+            std::uint8_t octet = 0;
+            int octet_begin = octet_idx * 8;
+            for (int i = 0; i < 8; ++i) {
+                octet = std::uint8_t(octet << 1);
+                if (octet_begin + i < bits) {
+                    octet |= std::uint8_t(bitarray[octet_begin + i]);
+                }
+            }
+            res[octet_idx] = octet;
+        }
 
         return res;
     }
 
-    template<int bits>
-    static std::array<bool, bits> deserialize_bitarray(const std::vector<std::uint8_t>::const_iterator &begin, const std::vector<std::uint8_t>::const_iterator &end) {
+    template<int bits, typename OctetIterator>
+    static std::array<bool, bits> deserialize_bitarray(const OctetIterator &begin, const OctetIterator &end) {
         constexpr int octets = bits/8 + (bits%8 ? 1 : 0);
-        constexpr int bits_ceil = octets*8;
 
-        std::array<std::uint8_t, octets> in {};
         BOOST_ASSERT(std::distance(begin, end) == octets);
-        std::copy_n(begin, octets, in.begin());
-
-        std::array<bool, bits_ceil> out {};
-        nil::crypto3::detail::pack<nil::crypto3::stream_endian::big_octet_big_bit, nil::crypto3::stream_endian::big_octet_big_bit, 8, 1>(in.begin(), in.end(), out.begin());
 
         std::array<bool, bits> res;
-        std::copy_n(out.begin(), bits, res.begin());
+        auto it = begin;
+        for (int octet_idx = 0; octet_idx < octets; ++octet_idx, ++it) {
+            std::uint8_t octet = *it;
+            int octet_begin = octet_idx * 8;
+            for (int i = 0; i < 8 && octet_begin + i < bits; ++i) {
+                res[octet_begin + i] = (octet >> (7 - i)) & 1;
+            }
+        }
 
         return res;
     }
@@ -613,6 +769,13 @@ struct marshaling_policy {
         return deserialize_bitarray<bits>(blob.begin(), blob.end());
     }
 
+    // Same blob as deserialize_bitarray reads, kept packed.
+    template<std::size_t bits>
+    static digest<bits> deserialize_digest(blob_view blob) {
+        BOOST_ASSERT_MSG(blob.size() == digest<bits>::octets, "Blob size doesn't match the digest size!");
+        return digest<bits>::from_octets(blob.data());
+    }
+
     static containers::merkle_tree<encrypted_input_policy::merkle_hash_type, encrypted_input_policy::arity>
     deserialize_merkle_tree(std::size_t tree_depth, std::vector<std::uint8_t> merkle_tree_blob) {
         std::size_t tree_length = containers::detail::merkle_tree_length(1 << tree_depth, encrypted_input_policy::arity);
@@ -650,21 +813,17 @@ struct marshaling_policy {
     //     return deserialize_voters_public_keys(tree_depth, blobs);
     // }
 
-    static std::vector<std::array<bool, encrypted_input_policy::public_key_bits>>
+    static std::vector<encrypted_input_policy::public_key_type>
     deserialize_voters_public_keys(std::size_t tree_depth, const std::vector<std::vector<std::uint8_t>> &blobs) {
         std::size_t participants_number = 1 << tree_depth;
         BOOST_ASSERT(blobs.size() <= participants_number);
-        std::vector<std::array<bool, encrypted_input_policy::public_key_bits>> result;
+        std::vector<encrypted_input_policy::public_key_type> result;
+        result.reserve(participants_number);
 
         for (auto i = 0; i < blobs.size(); i++) {
-            result.emplace_back(deserialize_bitarray<encrypted_input_policy::public_key_bits>(blobs[i]));
-        }
-
-        for (auto i = blobs.size(); i < participants_number; i++) {
-            result.emplace_back(
-                    std::array<bool, encrypted_input_policy::public_key_bits> {}
-            );
+            result.emplace_back(deserialize_digest<encrypted_input_policy::public_key_bits>(blobs[i]));
         }
+        result.resize(participants_number);
 
         return result;
     }
@@ -676,10 +835,10 @@ struct marshaling_policy {
     //             std::function(nil::crypto3::marshalling::types::make_public_key<elgamal_public_key_type, endianness>));
     // }
 
-    static elgamal_public_key_type deserialize_pk_eid(const std::vector<std::uint8_t> &pk_eid_blob) {
+    static elgamal_public_key_type deserialize_pk_eid(blob_view pk_eid_blob) {
         return deserialize_obj<public_key_marshaling_type, elgamal_public_key_type>(
                 pk_eid_blob,
-                std::function(nil::crypto3::marshalling::types::make_public_key<elgamal_public_key_type, endianness>));
+                nil::crypto3::marshalling::types::make_public_key<elgamal_public_key_type, endianness>);
     }
 
     // static elgamal_verification_key_type read_vk_eid(const boost::program_options::variables_map &vm) {
@@ -690,11 +849,10 @@ struct marshaling_policy {
     //                     nil::crypto3::marshalling::types::make_verification_key<elgamal_verification_key_type, endianness>));
     // }
 
-    static elgamal_verification_key_type deserialize_vk_eid(const std::vector<std::uint8_t> &vk_eid_blob) {
+    static elgamal_verification_key_type deserialize_vk_eid(blob_view vk_eid_blob) {
         return deserialize_obj<verification_key_marshaling_type, elgamal_verification_key_type>(
                 vk_eid_blob,
-                std::function(
-                        nil::crypto3::marshalling::types::make_verification_key<elgamal_verification_key_type, endianness>));
+                nil::crypto3::marshalling::types::make_verification_key<elgamal_verification_key_type, endianness>);
     }
 
     // static elgamal_private_key_type read_sk_eid(const boost::program_options::variables_map &vm) {
@@ -704,10 +862,10 @@ struct marshaling_policy {
     //             std::function(nil::crypto3::marshalling::types::make_private_key<elgamal_private_key_type, endianness>));
     // }
 
-    static elgamal_private_key_type deserialize_sk_eid(const std::vector<std::uint8_t> &sk_eid_blob) {
+    static elgamal_private_key_type deserialize_sk_eid(blob_view sk_eid_blob) {
         return deserialize_obj<secret_key_marshaling_type, elgamal_private_key_type>(
                 sk_eid_blob,
-                std::function(nil::crypto3::marshalling::types::make_private_key<elgamal_private_key_type, endianness>));
+                nil::crypto3::marshalling::types::make_private_key<elgamal_private_key_type, endianness>);
     }
 
     // static verification_key_type read_vk_crs(const boost::program_options::variables_map &vm) {
@@ -717,10 +875,10 @@ struct marshaling_policy {
     //                                        verification_key_type, endianness>));
     // }
 
-    static verification_key_type deserialize_vk_crs(const std::vector<std::uint8_t> &vk_crs_blob) {
+    static verification_key_type deserialize_vk_crs(blob_view vk_crs_blob) {
         return deserialize_obj<r1cs_verification_key_marshaling_type, verification_key_type>(
-                vk_crs_blob, std::function(nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_verification_key<
-                                           verification_key_type, endianness>));
+                vk_crs_blob, nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_verification_key<
+                        verification_key_type, endianness>);
     }
 
     // static proving_key_type read_pk_crs(const boost::program_options::variables_map &vm) {
@@ -731,11 +889,10 @@ struct marshaling_policy {
     //                     nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_fast_proving_key<proving_key_type, endianness>));
     // }
 
-    static proving_key_type deserialize_pk_crs(const std::vector<std::uint8_t> &pk_crs_blob) {
+    static proving_key_type deserialize_pk_crs(blob_view pk_crs_blob) {
         return deserialize_obj<r1cs_proving_key_marshalling_type, proving_key_type>(
                 pk_crs_blob,
-                std::function(
-                        nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_fast_proving_key<proving_key_type, endianness>));
+                nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_fast_proving_key<proving_key_type, endianness>);
     }
 
     // static proof_type read_proof(const boost::program_options::variables_map &vm, std::size_t proof_idx) {
@@ -745,6 +902,12 @@ struct marshaling_policy {
     //             std::function(nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_proof<proof_type, endianness>));
     // }
 
+    static proof_type deserialize_proof(blob_view proof_blob, nil::marshalling::status_type *status = nullptr) {
+        return deserialize_obj<r1cs_proof_marshaling_type, proof_type>(
+                proof_blob,
+                nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_proof<proof_type, endianness>, status);
+    }
+
     // static typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type
     // read_ct(const boost::program_options::variables_map &vm, std::size_t proof_idx) {
     //     return deserialize_obj<ct_marshaling_type,
@@ -756,13 +919,13 @@ struct marshaling_policy {
     // }
 
     static typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type
-    deserialize_ct(const std::vector<std::uint8_t> &blob) {
+    deserialize_ct(blob_view blob, nil::marshalling::status_type *status = nullptr) {
         return deserialize_obj<ct_marshaling_type,
                 typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type>(
                 blob,
-                std::function(
-                        nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_encrypted_primary_input<
-                        typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type, endianness>));
+                nil::crypto3::marshalling::types::make_r1cs_gg_ppzksnark_encrypted_primary_input<
+                        typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type, endianness>,
+                status);
     }
 
     // static typename encrypted_input_policy::encryption_scheme_type::decipher_type::second_type
@@ -774,7 +937,7 @@ struct marshaling_policy {
     // }
 
     static typename encrypted_input_policy::encryption_scheme_type::decipher_type::second_type
-    deserialize_decryption_proof(const std::vector<std::uint8_t> &dec_proof_blob) {
+    deserialize_decryption_proof(blob_view dec_proof_blob) {
         nil::marshalling::status_type status;
         return static_cast<typename encrypted_input_policy::encryption_scheme_type::decipher_type::second_type>(
                 nil::marshalling::pack<endianness>(dec_proof_blob, status));
@@ -804,100 +967,603 @@ generate_random_data(std::size_t leaf_number) {
     return v;
 }
 
+// Same as generate_random_data<bool, Bits>(1), packed.
+template<std::size_t Bits>
+digest<Bits> generate_random_digest() {
+    digest<Bits> result;
+    srand_once();
+    for (std::size_t i = 0; i < Bits; ++i) {
+        result.set(i, std::rand() % 2);
+    }
+    return result;
+}
+
+// Hash of the bits, packed. crypto3 hashes take and produce bit ranges, so digests are unpacked only for the duration
+// of the hash.
+template<typename Hash, typename BitRange>
+digest<Hash::digest_bits> hash_digest(const BitRange &bits) {
+    std::vector<bool> result = hash<Hash>(bits);
+    return digest<Hash::digest_bits>::from_bits(result);
+}
+
+// Number of worker threads to use when threads_number are requested, zero meaning one per core.
+std::size_t resolve_threads_number(std::size_t threads_number) {
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+    return 1;
+#else
+    if (threads_number == 0) {
+        threads_number = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    return threads_number;
+#endif
+}
+
+// Calls job(i) for every i in [0, jobs_number) on up to threads_number threads, zero meaning one thread per core. The
+// calling thread is one of the workers. Jobs are handed out one by one, so uneven jobs still keep every thread busy.
+template<typename Job>
+void parallel_for(std::size_t jobs_number, std::size_t threads_number, const Job &job) {
+    threads_number = std::min(resolve_threads_number(threads_number), jobs_number);
+
+    std::atomic<std::size_t> next_job(0);
+    auto worker = [&]() {
+        for (std::size_t i = next_job++; i < jobs_number; i = next_job++) {
+            job(i);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < threads_number; ++i) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto &w : workers) {
+        w.join();
+    }
+}
+
+// How much of the constraint system is evaluated while the vote witness is generated. Every check is a full pass over
+// all the constraints, so per-step checking is meant for debugging only.
+enum class witness_check_level : std::uint8_t {
+    none = 0,
+    final_only = 1,
+    per_step = 2,
+};
+
+// R1CS of the encrypted input voting. It depends only on (tree_depth, eid_bits), so the same constraint system is
+// used for CRS generation and for proving; generate_witness() resets the assignment before filling it for a ballot.
+struct voting_circuit {
+    using field_type = encrypted_input_policy::field_type;
+    using merkle_proof_type = containers::merkle_proof<encrypted_input_policy::merkle_hash_type, encrypted_input_policy::arity>;
+
+    voting_circuit(std::size_t tree_depth, std::size_t eid_bits) :
+        tree_depth(tree_depth),
+        eid_bits(eid_bits),
+        chunk_size(field_type::value_bits - 1),
+        m_block(bp, encrypted_input_policy::msg_size),
+        eid_packed(allocate_vector(bp, (eid_bits + (chunk_size - 1)) / chunk_size)),
+        sn_packed(allocate_vector(bp, (encrypted_input_policy::hash_component::digest_bits + (chunk_size - 1)) / chunk_size)),
+        root_packed(allocate_vector(bp, (encrypted_input_policy::hash_component::digest_bits + (chunk_size - 1)) / chunk_size)),
+        primary_input_size(bp.num_variables()),
+        eid_block(bp, eid_bits),
+        sn_digest(bp, encrypted_input_policy::hash_component::digest_bits),
+        root_digest(bp, encrypted_input_policy::merkle_hash_component::digest_bits),
+        eid_packer(bp, eid_block.bits, eid_packed, chunk_size),
+        sn_packer(bp, sn_digest.bits, sn_packed, chunk_size),
+        root_packer(bp, root_digest.bits, root_packed, chunk_size),
+        address_bits_va(allocate_vector(bp, tree_depth)),
+        path_var(bp, tree_depth),
+        sk_block(bp, encrypted_input_policy::secret_key_bits),
+        vote_var(bp, m_block, eid_block, sn_digest, root_digest, address_bits_va, path_var, sk_block,
+                 components::blueprint_variable<field_type>(0)) {
+        eid_packer.generate_r1cs_constraints(true);
+        sn_packer.generate_r1cs_constraints(true);
+        root_packer.generate_r1cs_constraints(true);
+
+        path_var.generate_r1cs_constraints();
+        vote_var.generate_r1cs_constraints();
+        logln("R1CS generation finished." );
+        logln("Constraints number in the generated R1CS: " , bp.num_constraints() );
+        logln("Variables number in the generated R1CS: " , bp.num_variables() );
+        bp.set_input_sizes(primary_input_size);
+    }
+
+    voting_circuit(const voting_circuit &) = delete;
+    voting_circuit &operator=(const voting_circuit &) = delete;
+
+    void generate_witness(const merkle_proof_type &path, const std::vector<bool> &root, const std::vector<bool> &m,
+                          const std::vector<bool> &eid,
+                          const std::vector<bool> &sk,
+                          const std::vector<bool> &sn,
+                          witness_check_level check_level = witness_check_level::final_only) {
+        const bool check_steps = check_level == witness_check_level::per_step;
+        bp.clear_values();
+
+        path_var.generate_r1cs_witness(path, true);
+        BOOST_ASSERT(!check_steps || !bp.is_satisfied());
+        address_bits_va.fill_with_bits_of_ulong(bp, path_var.address);
+        BOOST_ASSERT(!check_steps || !bp.is_satisfied());
+        BOOST_ASSERT(address_bits_va.get_field_element_from_bits(bp) == path_var.address);
+        m_block.generate_r1cs_witness(m);
+        BOOST_ASSERT(!check_steps || !bp.is_satisfied());
+        eid_block.generate_r1cs_witness(eid);
+        BOOST_ASSERT(!check_steps || !bp.is_satisfied());
+        sk_block.generate_r1cs_witness(sk);
+        BOOST_ASSERT(!check_steps || !bp.is_satisfied());
+        vote_var.generate_r1cs_witness(root, sn);
+        BOOST_ASSERT(!check_steps || !bp.is_satisfied());
+        eid_packer.generate_r1cs_witness_from_bits();
+        BOOST_ASSERT(!check_steps || !bp.is_satisfied());
+        root_packer.generate_r1cs_witness_from_bits();
+        BOOST_ASSERT(!check_steps || !bp.is_satisfied());
+        sn_packer.generate_r1cs_witness_from_bits();
+        BOOST_ASSERT_MSG(check_level == witness_check_level::none || bp.is_satisfied(),
+                         "Vote witness doesn't satisfy the voting R1CS!");
+    }
+
+    std::size_t eid_offset() const {
+        return encrypted_input_policy::msg_size;
+    }
+
+    std::size_t sn_offset() const {
+        return eid_offset() + eid_packed.size();
+    }
+
+    std::size_t rt_offset() const {
+        return sn_offset() + sn_packed.size();
+    }
+
+    const std::size_t tree_depth;
+    const std::size_t eid_bits;
+    const std::size_t chunk_size;
+
+    components::blueprint<field_type> bp;
+    components::block_variable<field_type> m_block;
+    components::blueprint_variable_vector<field_type> eid_packed;
+    components::blueprint_variable_vector<field_type> sn_packed;
+    components::blueprint_variable_vector<field_type> root_packed;
+    const std::size_t primary_input_size;
+    components::block_variable<field_type> eid_block;
+    components::digest_variable<field_type> sn_digest;
+    components::digest_variable<field_type> root_digest;
+    components::multipacking_component<field_type> eid_packer;
+    components::multipacking_component<field_type> sn_packer;
+    components::multipacking_component<field_type> root_packer;
+    components::blueprint_variable_vector<field_type> address_bits_va;
+    encrypted_input_policy::merkle_proof_component path_var;
+    components::block_variable<field_type> sk_block;
+    encrypted_input_policy::voting_component vote_var;
+
+private:
+    static components::blueprint_variable_vector<field_type> allocate_vector(components::blueprint<field_type> &bp,
+                                                                             std::size_t size) {
+        components::blueprint_variable_vector<field_type> result;
+        result.allocate(bp, size);
+        return result;
+    }
+};
+
+// Circuits are generated once per (tree_depth, eid_bits) and recycled: acquire() hands out a circuit which goes back
+// to the pool when its last reference is dropped, so concurrent provers never share an assignment.
+class voting_circuit_pool {
+public:
+    static std::shared_ptr<voting_circuit> acquire(std::size_t tree_depth, std::size_t eid_bits) {
+        static voting_circuit_pool pool;
+        return pool.get(tree_depth, eid_bits);
+    }
+
+private:
+    std::shared_ptr<voting_circuit> get(std::size_t tree_depth, std::size_t eid_bits) {
+        std::unique_ptr<voting_circuit> circuit;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto &free_circuits = circuits[{tree_depth, eid_bits}];
+            if (!free_circuits.empty()) {
+                circuit = std::move(free_circuits.back());
+                free_circuits.pop_back();
+            }
+        }
+        if (!circuit) {
+            logln("Generating R1CS for tree depth " , tree_depth , " and eid of " , eid_bits , " bits..." );
+            circuit = std::make_unique<voting_circuit>(tree_depth, eid_bits);
+        }
+        return std::shared_ptr<voting_circuit>(circuit.release(), [this](voting_circuit *released) {
+            std::lock_guard<std::mutex> lock(mutex);
+            circuits[{released->tree_depth, released->eid_bits}].emplace_back(released);
+        });
+    }
+
+    std::mutex mutex;
+    std::map<std::pair<std::size_t, std::size_t>, std::vector<std::unique_ptr<voting_circuit>>> circuits;
+};
+
+// Deserialized CRS keypairs, keyed by the SHA-256 digests of their blobs. Parsing the proving key is the dominant
+// cost of opening a session, processes casting or tallying many times against the same CRS (WASM, mobile, servers)
+// pay for it once. Hashing a blob is a single pass over its octets. Least recently used keypair is evicted first.
+// One-shot callers set the capacity to 0, then every acquire deserializes the blobs and nothing is kept or hashed.
+class crs_cache {
+public:
+    using keypair_type = typename encrypted_input_policy::proof_system::keypair_type;
+    using digest_hash_type = hashes::sha2<256>;
+
+    static constexpr std::size_t default_capacity = 4;
+
+    static std::shared_ptr<const keypair_type> acquire(blob_view proving_key_blob, blob_view verification_key_blob) {
+        return instance().get(proving_key_blob, verification_key_blob);
+    }
+
+    // Evicts the least recently used keypairs beyond the capacity.
+    static void set_capacity(std::size_t capacity) {
+        crs_cache &cache = instance();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.capacity = capacity;
+        cache.trim();
+    }
+
+    static void clear() {
+        crs_cache &cache = instance();
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        cache.keypairs.clear();
+    }
+
+private:
+    using digest_type = typename digest_hash_type::digest_type;
+    using key_type = std::pair<digest_type, digest_type>;
+    using entry_type = std::pair<key_type, std::shared_ptr<const keypair_type>>;
+
+    static crs_cache &instance() {
+        static crs_cache cache;
+        return cache;
+    }
+
+    // Moves the entry of the key to the front and returns its keypair, if there is one.
+    std::shared_ptr<const keypair_type> touch(const key_type &key) {
+        auto it = std::find_if(keypairs.begin(), keypairs.end(),
+                               [&](const entry_type &entry) { return entry.first == key; });
+        if (it == keypairs.end()) {
+            return nullptr;
+        }
+        keypairs.splice(keypairs.begin(), keypairs, it);
+        return it->second;
+    }
+
+    void trim() {
+        while (keypairs.size() > capacity) {
+            keypairs.pop_back();
+        }
+    }
+
+    static std::shared_ptr<const keypair_type> deserialize(blob_view proving_key_blob,
+                                                           blob_view verification_key_blob) {
+        logln("Deserializing CRS..." );
+        return std::make_shared<const keypair_type>(marshaling_policy::deserialize_pk_crs(proving_key_blob),
+                                                    marshaling_policy::deserialize_vk_crs(verification_key_blob));
+    }
+
+    std::shared_ptr<const keypair_type> get(blob_view proving_key_blob, blob_view verification_key_blob) {
+        std::size_t current_capacity;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current_capacity = capacity;
+        }
+        if (current_capacity == 0) {
+            return deserialize(proving_key_blob, verification_key_blob);
+        }
+        key_type key {hash<digest_hash_type>(proving_key_blob.begin(), proving_key_blob.end()),
+                      hash<digest_hash_type>(verification_key_blob.begin(), verification_key_blob.end())};
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (auto keypair = touch(key)) {
+                return keypair;
+            }
+        }
+
+        auto keypair = deserialize(proving_key_blob, verification_key_blob);
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto deserialized = touch(key)) {
+            return deserialized;
+        }
+        keypairs.emplace_front(key, keypair);
+        trim();
+        return keypair;
+    }
+
+    std::mutex mutex;
+    std::size_t capacity = default_capacity;
+    std::list<entry_type> keypairs;
+};
+
+// Groth16 CRS generated for a constraint system, keyed by the SHA-256 digest of the constraint system. The voting
+// circuit only depends on tree_depth, eid_bits and msg_size, so elections of the same shape share one trusted setup
+// and only their El-Gamal keys are fresh. Blobs are kept along the keypair, a hit costs hashing the constraint system.
+// Builds with CRS_STORE_ON_DISK (native ones) can also keep the blobs in the directory of set_directory, so the CRS
+// outlives the process. WASM and mobile builds keep no CRS unless they set a capacity, they usually open a single
+// election per process and would only hold the keys in memory. A capacity of 0 generates the CRS on every call.
+class crs_store {
+public:
+    using keypair_type = crs_cache::keypair_type;
+    using constraint_system_type = typename encrypted_input_policy::proof_system::constraint_system_type;
+    using digest_hash_type = hashes::sha2<256>;
+    using digest_type = typename digest_hash_type::digest_type;
+
+    struct entry {
+        std::shared_ptr<const keypair_type> keypair;
+        std::vector<std::uint8_t> proving_key_blob;
+        std::vector<std::uint8_t> verification_key_blob;
+    };
+
+#ifdef CRS_STORE_ON_DISK
+    static constexpr std::size_t default_capacity = 4;
+#else
+    static constexpr std::size_t default_capacity = 0;
+#endif
+
+    static std::shared_ptr<const entry> acquire(const constraint_system_type &constraint_system) {
+        return instance().get(constraint_system);
+    }
+
+    // Evicts the least recently used CRS beyond the capacity, the stored directory is left as is.
+    static void set_capacity(std::size_t capacity) {
+        crs_store &store = instance();
+        std::lock_guard<std::mutex> lock(store.mutex);
+        store.capacity = capacity;
+        store.trim();
+    }
+
+    static void clear() {
+        crs_store &store = instance();
+        std::lock_guard<std::mutex> lock(store.mutex);
+        store.entries.clear();
+    }
+
+#ifdef CRS_STORE_ON_DISK
+    // Directory of the CRS blobs, <digest>.pk.bin and <digest>.vk.bin, created on the first store. Empty keeps the
+    // CRS in memory only.
+    static void set_directory(const std::string &directory) {
+        crs_store &store = instance();
+        std::lock_guard<std::mutex> lock(store.mutex);
+        store.directory = directory;
+    }
+#endif
+
+    // Digest of the input sizes and of every term of every constraint. Terms are hashed constraint by constraint, as
+    // the big-endian term counts and indices followed by the marshalled coefficients.
+    static digest_type digest(const constraint_system_type &constraint_system) {
+        using scalar_field_value_type =
+                typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type;
+
+        accumulator_set<digest_hash_type> acc;
+        std::vector<std::uint8_t> indices;
+        std::vector<scalar_field_value_type> coefficients;
+        auto append_index = [&](std::size_t value) {
+            for (std::size_t i = 0; i < 8; ++i) {
+                indices.emplace_back(std::uint8_t(value >> (8 * (7 - i))));
+            }
+        };
+        auto append_linear_combination = [&](const auto &linear_combination) {
+            append_index(linear_combination.terms.size());
+            for (const auto &term : linear_combination.terms) {
+                append_index(term.index);
+                coefficients.emplace_back(term.coeff);
+            }
+        };
+
+        append_index(constraint_system.primary_input_size);
+        append_index(constraint_system.auxiliary_input_size);
+        append_index(constraint_system.constraints.size());
+        hash<digest_hash_type>(indices.begin(), indices.end(), acc);
+        for (const auto &constraint : constraint_system.constraints) {
+            indices.clear();
+            coefficients.clear();
+            append_linear_combination(constraint.a);
+            append_linear_combination(constraint.b);
+            append_linear_combination(constraint.c);
+            hash<digest_hash_type>(indices.begin(), indices.end(), acc);
+            std::vector<std::uint8_t> coefficients_blob = marshaling_policy::serialize_scalar_vector(coefficients);
+            hash<digest_hash_type>(coefficients_blob.begin(), coefficients_blob.end(), acc);
+        }
+        return accumulators::extract::hash<digest_hash_type>(acc);
+    }
+
+private:
+    using entry_type = std::pair<digest_type, std::shared_ptr<const entry>>;
+
+    static crs_store &instance() {
+        static crs_store store;
+        return store;
+    }
+
+    // Moves the entry of the key to the front and returns it, if there is one.
+    std::shared_ptr<const entry> touch(const digest_type &key) {
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [&](const entry_type &stored) { return stored.first == key; });
+        if (it == entries.end()) {
+            return nullptr;
+        }
+        entries.splice(entries.begin(), entries, it);
+        return it->second;
+    }
+
+    void trim() {
+        while (entries.size() > capacity) {
+            entries.pop_back();
+        }
+    }
+
+    std::shared_ptr<const entry> insert(const digest_type &key, std::shared_ptr<const entry> inserted) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (auto stored = touch(key)) {
+            return stored;
+        }
+        entries.emplace_front(key, inserted);
+        trim();
+        return inserted;
+    }
+
+    static std::shared_ptr<const entry> generate(const constraint_system_type &constraint_system) {
+        logln("Administrator generates CRS for " , constraint_system.num_constraints() , " constraints..." );
+        stopwatch step;
+        auto generated = std::make_shared<entry>();
+        generated->keypair = std::make_shared<const keypair_type>(
+                nil::crypto3::zk::generate<encrypted_input_policy::proof_system>(constraint_system));
+        logln("CRS generation finished in " , step.elapsed_ms() , " ms." );
+        marshaling_policy::serialize_crs(generated->keypair->first, generated->keypair->second,
+                                         generated->proving_key_blob, generated->verification_key_blob);
+        return generated;
+    }
+
+#ifdef CRS_STORE_ON_DISK
+    static std::string hex(const digest_type &key) {
+        static const char digits[] = "0123456789abcdef";
+        std::string result;
+        for (std::uint8_t octet : key) {
+            result.push_back(digits[octet >> 4]);
+            result.push_back(digits[octet & 0xf]);
+        }
+        return result;
+    }
+
+    static bool read_file(const std::filesystem::path &path, std::vector<std::uint8_t> &blob) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            return false;
+        }
+        blob.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return !in.bad();
+    }
+
+    // Writes a temporary file and renames it, so readers never see a partially written blob.
+    static void write_file(const std::filesystem::path &path, const std::vector<std::uint8_t> &blob) {
+        std::filesystem::path temporary = path;
+        temporary += ".tmp";
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char *>(blob.data()), blob.size());
+            if (!out) {
+                logln("Failed to write " , temporary.string());
+                return;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temporary, path, error);
+        if (error) {
+            logln("Failed to store " , path.string() , ": " , error.message());
+        }
+    }
+
+    // Blobs found under the digest are only trusted once the proving key holds the very same constraint system, a
+    // stale or foreign file is treated as a miss and overwritten by the generated CRS.
+    std::shared_ptr<const entry> load(const std::string &stored_directory, const digest_type &key,
+                                      const constraint_system_type &constraint_system) {
+        std::filesystem::path prefix = std::filesystem::path(stored_directory) / hex(key);
+        auto loaded = std::make_shared<entry>();
+        if (!read_file(prefix.string() + ".pk.bin", loaded->proving_key_blob) ||
+            !read_file(prefix.string() + ".vk.bin", loaded->verification_key_blob)) {
+            return nullptr;
+        }
+        logln("Loading CRS generated for the same constraint system from " , stored_directory , "..." );
+        loaded->keypair = std::make_shared<const keypair_type>(
+                marshaling_policy::deserialize_pk_crs(loaded->proving_key_blob),
+                marshaling_policy::deserialize_vk_crs(loaded->verification_key_blob));
+        if (!(loaded->keypair->first.constraint_system == constraint_system)) {
+            logln("CRS in " , prefix.string() , " is for another constraint system, generating it again." );
+            return nullptr;
+        }
+        return loaded;
+    }
+
+    void store(const std::string &stored_directory, const digest_type &key, const entry &generated) {
+        std::error_code error;
+        std::filesystem::create_directories(stored_directory, error);
+        if (error) {
+            logln("Failed to create " , stored_directory , ": " , error.message());
+            return;
+        }
+        std::filesystem::path prefix = std::filesystem::path(stored_directory) / hex(key);
+        write_file(prefix.string() + ".vk.bin", generated.verification_key_blob);
+        write_file(prefix.string() + ".pk.bin", generated.proving_key_blob);
+    }
+#endif
+
+    std::shared_ptr<const entry> get(const constraint_system_type &constraint_system) {
+        std::string stored_directory;
+        std::size_t current_capacity;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            current_capacity = capacity;
+#ifdef CRS_STORE_ON_DISK
+            stored_directory = directory;
+#endif
+        }
+        if (current_capacity == 0 && stored_directory.empty()) {
+            return generate(constraint_system);
+        }
+
+        digest_type key = digest(constraint_system);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (auto stored = touch(key)) {
+                logln("Reusing CRS generated for the same constraint system." );
+                return stored;
+            }
+        }
+
+#ifdef CRS_STORE_ON_DISK
+        if (!stored_directory.empty()) {
+            if (auto loaded = load(stored_directory, key, constraint_system)) {
+                return insert(key, loaded);
+            }
+        }
+#endif
+
+        auto generated = generate(constraint_system);
+#ifdef CRS_STORE_ON_DISK
+        if (!stored_directory.empty()) {
+            store(stored_directory, key, *generated);
+        }
+#endif
+        return insert(key, generated);
+    }
+
+    std::mutex mutex;
+    std::size_t capacity = default_capacity;
+    std::list<entry_type> entries;
+#ifdef CRS_STORE_ON_DISK
+    std::string directory;
+#endif
+};
+
 void process_encrypted_input_mode_init_voter_phase(std::size_t voter_idx, std::vector<std::uint8_t> &voter_pk_out,
                                                    std::vector<std::uint8_t> &voter_sk_out) {
     using scalar_field_value_type = typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type;
 
     std::size_t proof_idx = voter_idx;
     logln("Voter " , proof_idx , " generates its public and secret keys..." , "\n");
-    auto secret_keys = generate_random_data<bool, encrypted_input_policy::secret_key_bits>(1);
-    std::vector<std::array<bool, encrypted_input_policy::public_key_bits>> public_keys;
-    std::array<bool, encrypted_input_policy::public_key_bits> pk {};
-    hash<encrypted_input_policy::merkle_hash_type>(secret_keys[0], std::begin(pk));
-    public_keys.emplace_back(pk);
+    auto sk = generate_random_digest<encrypted_input_policy::secret_key_bits>();
+    auto pk = hash_digest<encrypted_input_policy::merkle_hash_type>(sk.to_bits());
 
     log("Public key of the Voter " , proof_idx , ": ");
-    for (auto c : pk) {
-        log(int(c));
+    for (std::size_t i = 0; i < pk.bits; ++i) {
+        log(int(pk[i]));
     }
 
     logln();
     logln("Participants key pairs generated." );
 
     logln("Voter " , proof_idx , " keypair marshalling started..." );
-    marshaling_policy::serialize_initial_phase_voter_data(pk, secret_keys[0], voter_pk_out, voter_sk_out);
+    marshaling_policy::serialize_initial_phase_voter_data(pk, sk, voter_pk_out, voter_sk_out);
     logln("Marshalling finished." );
 }
 
-void process_encrypted_input_mode_init_admin_phase_generate_keys(
-    std::size_t tree_depth,  std::size_t eid_bits,
-    std::vector<std::uint8_t> &r1cs_proving_key_out, std::vector<std::uint8_t> &r1cs_verification_key_out,
-    std::vector<std::uint8_t> &public_key_output, std::vector<std::uint8_t> &secret_key_output,
-    std::vector<std::uint8_t> &verification_key_output
-) {
+// Draws the El-Gamal keys of one election for the CRS. Costs msg_size * 3 + 2 random scalars and a handful of
+// multiplications, however large the circuit is.
+void generate_elgamal_keys(const crs_cache::keypair_type &gg_keypair, std::vector<std::uint8_t> &public_key_output,
+                           std::vector<std::uint8_t> &secret_key_output,
+                           std::vector<std::uint8_t> &verification_key_output) {
     using scalar_field_value_type = typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type;
 
-    logln("Voting system administrator generates R1CS..." );
-    components::blueprint<encrypted_input_policy::field_type> bp;
-    components::block_variable<encrypted_input_policy::field_type> m_block(bp, encrypted_input_policy::msg_size);
-
-    std::size_t chunk_size = encrypted_input_policy::field_type::value_bits - 1;
-
-    components::blueprint_variable_vector<encrypted_input_policy::field_type> eid_packed;
-    std::size_t eid_packed_size = (eid_bits + (chunk_size - 1)) / chunk_size;
-    eid_packed.allocate(bp, eid_packed_size);
-
-    components::blueprint_variable_vector<encrypted_input_policy::field_type> sn_packed;
-    std::size_t sn_packed_size = (encrypted_input_policy::hash_component::digest_bits + (chunk_size - 1)) / chunk_size;
-    sn_packed.allocate(bp, sn_packed_size);
-
-    components::blueprint_variable_vector<encrypted_input_policy::field_type> root_packed;
-    std::size_t root_packed_size = (encrypted_input_policy::hash_component::digest_bits + (chunk_size - 1)) / chunk_size;
-    root_packed.allocate(bp, root_packed_size);
-
-    std::size_t primary_input_size = bp.num_variables();
-
-    components::block_variable<encrypted_input_policy::field_type> eid_block(bp, eid_bits);
-    components::digest_variable<encrypted_input_policy::field_type> sn_digest(
-            bp, encrypted_input_policy::hash_component::digest_bits);
-    components::digest_variable<encrypted_input_policy::field_type> root_digest(
-            bp, encrypted_input_policy::merkle_hash_component::digest_bits);
-    logln("Variables number in the generated R1CS: " , bp.num_variables() );
-
-    components::multipacking_component<encrypted_input_policy::field_type> eid_packer(bp, eid_block.bits, eid_packed, chunk_size);
-    components::multipacking_component<encrypted_input_policy::field_type> sn_packer(bp, sn_digest.bits, sn_packed, chunk_size);
-    components::multipacking_component<encrypted_input_policy::field_type> root_packer(bp, root_digest.bits, root_packed, chunk_size);
-    logln("Variables number in the generated R1CS: " , bp.num_variables() );
-
-    components::blueprint_variable_vector<encrypted_input_policy::field_type> address_bits_va;
-    address_bits_va.allocate(bp, tree_depth);
-    encrypted_input_policy::merkle_proof_component path_var(bp, tree_depth);
-    components::block_variable<encrypted_input_policy::field_type> sk_block(bp,
-                                                                            encrypted_input_policy::secret_key_bits);
-    logln("Variables number in the generated R1CS: " , bp.num_variables() );
-    encrypted_input_policy::voting_component vote_var(
-            bp, m_block, eid_block, sn_digest, root_digest, address_bits_va, path_var, sk_block,
-            components::blueprint_variable<encrypted_input_policy::field_type>(0));
-    logln("Variables number in the generated R1CS: " , bp.num_variables() );
-
-    eid_packer.generate_r1cs_constraints(true);
-    sn_packer.generate_r1cs_constraints(true);
-    root_packer.generate_r1cs_constraints(true);
-
-    path_var.generate_r1cs_constraints();
-    vote_var.generate_r1cs_constraints();
-    logln("R1CS generation finished." );
-    logln("Constraints number in the generated R1CS: " , bp.num_constraints() );
-    logln("Variables number in the generated R1CS: " , bp.num_variables() );
-    bp.set_input_sizes(primary_input_size);
-
-    logln("Administrator generates CRS..." );
-    typename encrypted_input_policy::proof_system::keypair_type gg_keypair =
-            nil::crypto3::zk::generate<encrypted_input_policy::proof_system>(bp.get_constraint_system());
-    logln("CRS generation finished." );
-
     logln("Administrator generates private, public and verification keys for El-Gamal verifiable encryption "
           "scheme...");
+    stopwatch step;
     random::algebraic_random_device<typename encrypted_input_policy::pairing_curve_type::scalar_field_type> d;
     std::vector<scalar_field_value_type> rnd;
     for (std::size_t i = 0; i < encrypted_input_policy::msg_size * 3 + 2; ++i) {
@@ -907,34 +1573,186 @@ void process_encrypted_input_mode_init_admin_phase_generate_keys(
             generate_keypair<encrypted_input_policy::encryption_scheme_type,
     modes::verifiable_encryption<encrypted_input_policy::encryption_scheme_type>>(
             rnd, {gg_keypair, encrypted_input_policy::msg_size});
-    logln("Private, public and verification keys for El-Gamal verifiable encryption scheme generated.", "\n");
-    logln("====================================================================" , "\n");
+    logln("Private, public and verification keys for El-Gamal verifiable encryption scheme generated in " ,
+          step.elapsed_ms() , " ms.", "\n");
 
-    logln("Administrator initial phase keys marshalling started..." );
+    marshaling_policy::serialize_elgamal_keys(std::get<0>(keypair), std::get<1>(keypair), std::get<2>(keypair),
+                                              public_key_output, secret_key_output, verification_key_output);
+}
 
-    marshaling_policy::serialize_initial_phase_admin_keys(
-    gg_keypair.first, gg_keypair.second, std::get<0>(keypair),
-    std::get<1>(keypair), std::get<2>(keypair), r1cs_proving_key_out,
-    r1cs_verification_key_out, public_key_output, secret_key_output,
-    verification_key_output);
-    logln("Marshalling finished." );
+// CRS generation is the slowest step of opening an election for deep trees. Every step is logged as it starts and
+// again with its time once it is finished, there is no report from within crypto3's generator. A non-zero
+// threads_number sizes the OpenMP pool of the calling thread for this call only, zero leaves it as the caller set it.
+// It only matters in MULTICORE builds and only as far as crypto3 runs the generator in that pool. CRS of a circuit
+// shape kept by crs_store is reused, El-Gamal keys are generated on every call.
+void process_encrypted_input_mode_init_admin_phase_generate_keys(
+    std::size_t tree_depth,  std::size_t eid_bits,
+    std::vector<std::uint8_t> &r1cs_proving_key_out, std::vector<std::uint8_t> &r1cs_verification_key_out,
+    std::vector<std::uint8_t> &public_key_output, std::vector<std::uint8_t> &secret_key_output,
+    std::vector<std::uint8_t> &verification_key_output, std::size_t threads_number = 0
+) {
+#ifdef MULTICORE
+    int caller_prover_threads = omp_get_max_threads();
+#endif
+    if (threads_number > 0) {
+        set_current_thread_prover_threads(threads_number);
+    }
+    stopwatch total;
+
+    logln("Voting system administrator generates R1CS..." );
+    stopwatch step;
+    auto circuit = voting_circuit_pool::acquire(tree_depth, eid_bits);
+    logln("R1CS generated in " , step.elapsed_ms() , " ms." );
+
+    auto crs = crs_store::acquire(circuit->bp.get_constraint_system());
+    r1cs_proving_key_out = crs->proving_key_blob;
+    r1cs_verification_key_out = crs->verification_key_blob;
+
+    generate_elgamal_keys(*crs->keypair, public_key_output, secret_key_output, verification_key_output);
+    logln("Administrator keys generated in " , total.elapsed_ms() , " ms." );
+#ifdef MULTICORE
+    omp_set_num_threads(caller_prover_threads);
+#endif
+}
+
+// Fresh El-Gamal keys of an election on the circuit of existing CRS blobs, e.g. to rotate election keys or to open
+// many elections of the same shape. No R1CS or CRS is generated.
+void process_encrypted_input_mode_init_admin_phase_generate_elgamal_keys(
+        blob_view proving_key_blob, blob_view verification_key_blob,
+        std::vector<std::uint8_t> &public_key_output, std::vector<std::uint8_t> &secret_key_output,
+        std::vector<std::uint8_t> &verification_key_output) {
+    auto gg_keypair = crs_cache::acquire(proving_key_blob, verification_key_blob);
+    generate_elgamal_keys(*gg_keypair, public_key_output, secret_key_output, verification_key_output);
+}
+
+// Layout of the Merkle tree blob. Dense blob is headerless: every node of the full tree, row by row starting from the
+// leaves. Sparse blob starts with sparse_merkle_tree_magic and the big-endian number of occupied leaves, followed by
+// the nodes having an occupied leaf below them (ceil(occupied / arity^level) first nodes of every level), row by row
+// starting from the leaves, and by the digests of the empty subtrees of every level, from the leaves up to the root.
+// Size of a sparse blob is proportional to the number of voters rather than to the capacity of the tree.
+enum class merkle_tree_format : std::uint8_t { dense = 0, sparse = 1 };
+
+constexpr std::array<std::uint8_t, 4> sparse_merkle_tree_magic = {'S', 'M', 'T', '1'};
+constexpr std::size_t sparse_merkle_tree_leaves_octets = 8;
+constexpr std::size_t sparse_merkle_tree_header_octets =
+        sparse_merkle_tree_magic.size() + sparse_merkle_tree_leaves_octets;
+
+// Builds the same tree as containers::make_merkle_tree over the public keys, padded with all-zero keys up to
+// 1 << tree_depth leaves, and returns it as the Merkle tree blob of the format, together with its root. Nodes of a
+// level don't depend on each other, so every level is hashed on up to threads_number threads (zero meaning one per
+// core), level by level from the leaves up. Sparse format hashes only the subtrees holding public keys, all the empty
+// subtrees of a level sharing one digest.
+std::vector<std::uint8_t> make_merkle_tree_blob(
+        std::size_t tree_depth, const std::vector<encrypted_input_policy::public_key_type> &public_keys,
+        encrypted_input_policy::merkle_node_type &root, std::size_t threads_number = 0,
+        merkle_tree_format format = merkle_tree_format::dense) {
+    using merkle_hash_type = encrypted_input_policy::merkle_hash_type;
+    constexpr std::size_t arity = encrypted_input_policy::arity;
+    using node_type = encrypted_input_policy::merkle_node_type;
+    constexpr std::size_t node_octets = node_type::octets;
+
+    std::size_t participants_number = std::size_t(1) << tree_depth;
+    BOOST_ASSERT_MSG(public_keys.size() <= participants_number, "Too many public keys for the tree depth!");
+    bool sparse = format == merkle_tree_format::sparse;
+    BOOST_ASSERT_MSG(sparse || public_keys.size() == participants_number,
+                     "Dense Merkle tree should be built upon padded public keys!");
+
+    auto hash_children = [&](const node_type *children[arity]) {
+        std::vector<bool> children_bits;
+        children_bits.reserve(arity * node_type::bits);
+        for (std::size_t j = 0; j < arity; ++j) {
+            children[j]->append_bits(children_bits);
+        }
+        return hash_digest<merkle_hash_type>(children_bits);
+    };
+
+    std::vector<node_type> empty_digests;
+    if (sparse) {
+        empty_digests.emplace_back(hash_digest<merkle_hash_type>(encrypted_input_policy::public_key_type().to_bits()));
+        for (std::size_t level = 1; level <= tree_depth; ++level) {
+            const node_type *children[arity];
+            std::fill(children, children + arity, &empty_digests.back());
+            empty_digests.emplace_back(hash_children(children));
+        }
+    }
+
+    std::vector<std::size_t> rows_sizes {public_keys.size()};
+    for (std::size_t level = 1; level <= tree_depth; ++level) {
+        rows_sizes.emplace_back((rows_sizes.back() + arity - 1) / arity);
+    }
+    std::size_t nodes_number = std::accumulate(rows_sizes.begin(), rows_sizes.end(), std::size_t(0)) +
+                               empty_digests.size();
+
+    std::size_t header_octets = sparse ? sparse_merkle_tree_header_octets : 0;
+    std::vector<std::uint8_t> blob(header_octets + nodes_number * node_octets);
+    if (sparse) {
+        std::copy(sparse_merkle_tree_magic.begin(), sparse_merkle_tree_magic.end(), blob.begin());
+        for (std::size_t i = 0; i < sparse_merkle_tree_leaves_octets; ++i) {
+            blob[sparse_merkle_tree_magic.size() + i] =
+                    std::uint8_t(public_keys.size() >> (8 * (sparse_merkle_tree_leaves_octets - 1 - i)));
+        }
+    }
+    auto write_node = [&](std::size_t node_idx, const node_type &node) {
+        std::copy(node.data(), node.data() + node_octets, blob.begin() + header_octets + node_idx * node_octets);
+    };
+
+    std::vector<node_type> row(public_keys.size());
+    parallel_for(public_keys.size(), threads_number, [&](std::size_t i) {
+        row[i] = hash_digest<merkle_hash_type>(public_keys[i].to_bits());
+        write_node(i, row[i]);
+    });
+
+    std::size_t row_begin = row.size();
+    for (std::size_t level = 1; level <= tree_depth; ++level) {
+        std::vector<node_type> parent_row(rows_sizes[level]);
+        parallel_for(parent_row.size(), threads_number, [&](std::size_t i) {
+            const node_type *children[arity];
+            for (std::size_t j = 0; j < arity; ++j) {
+                std::size_t child_idx = i * arity + j;
+                children[j] = child_idx < row.size() ? &row[child_idx] : &empty_digests[level - 1];
+            }
+            parent_row[i] = hash_children(children);
+            write_node(row_begin + i, parent_row[i]);
+        });
+        logln("Merkle tree level of " , parent_row.size() , " nodes hashed." );
+        row_begin += parent_row.size();
+        row = std::move(parent_row);
+    }
+
+    for (std::size_t level = 0; level < empty_digests.size(); ++level) {
+        write_node(row_begin + level, empty_digests[level]);
+    }
+
+    root = row.empty() ? empty_digests.back() : row.front();
+    return blob;
 }
 
 void process_encrypted_input_mode_init_admin_phase_generate_data(
         std::size_t tree_depth, std::size_t eid_bits, const std::vector<std::vector<std::uint8_t>> &public_keys_blobs,
         std::vector<std::uint8_t> &eid_output,
-        std::vector<std::uint8_t> &rt_output, std::vector<std::uint8_t> &merkle_tree_output) {
+        std::vector<std::uint8_t> &rt_output, std::vector<std::uint8_t> &merkle_tree_output,
+        std::size_t threads_number = 0, merkle_tree_format format = merkle_tree_format::dense) {
     using scalar_field_value_type = typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type;
 
-    auto public_keys = marshaling_policy::deserialize_voters_public_keys(tree_depth, public_keys_blobs);
+    std::vector<encrypted_input_policy::public_key_type> public_keys;
+    if (format == merkle_tree_format::sparse) {
+        BOOST_ASSERT(public_keys_blobs.size() <= (std::size_t(1) << tree_depth));
+        public_keys.reserve(public_keys_blobs.size());
+        for (const auto &public_key_blob : public_keys_blobs) {
+            public_keys.emplace_back(
+                    marshaling_policy::deserialize_digest<encrypted_input_policy::public_key_bits>(public_key_blob));
+        }
+    } else {
+        public_keys = marshaling_policy::deserialize_voters_public_keys(tree_depth, public_keys_blobs);
+    }
     logln("Finished deserialization of public keys" );
 
     logln("Administrator pre-initializes voting session..." , "\n");
 
     logln("Merkle tree generation upon participants public keys started..." );
-    auto tree = containers::make_merkle_tree<encrypted_input_policy::merkle_hash_type, encrypted_input_policy::arity>(
-            std::cbegin(public_keys), std::cend(public_keys));
-    std::vector<scalar_field_value_type> rt_field = marshaling_policy::get_multi_field_element_from_bits(tree.root());
+    encrypted_input_policy::merkle_node_type root;
+    std::vector<std::uint8_t> merkle_tree_blob = make_merkle_tree_blob(tree_depth, public_keys, root, threads_number, format);
+    std::vector<scalar_field_value_type> rt_field = marshaling_policy::get_multi_field_element_from_bits(root.to_bits());
     logln("Merkle tree generation finished." );
 
     std::vector<bool> eid(eid_bits);
@@ -947,218 +1765,853 @@ void process_encrypted_input_mode_init_admin_phase_generate_data(
     logln();
     std::vector<scalar_field_value_type> eid_field = marshaling_policy::get_multi_field_element_from_bits(eid);
 
-    std::vector<std::vector<bool>> hashes(tree.cbegin(), tree.cend());
-    std::size_t hashes_size = hashes.size();
-    std::vector<std::array<bool, encrypted_input_policy::merkle_hash_type::digest_bits>>
-            hashes_array_vector(hashes_size, std::array<bool, encrypted_input_policy::merkle_hash_type::digest_bits> {});
-    for(std::size_t i=0; i < hashes_size; ++i) {
-        std::copy_n(hashes[i].begin(),
-                    encrypted_input_policy::merkle_hash_type::digest_bits,
-                    hashes_array_vector[i].begin());
-    }
     logln("Administrator initial phase data marshalling started..." );
     marshaling_policy::serialize_initial_phase_admin_data(
-            eid_field, rt_field, hashes_array_vector,
+            eid_field, rt_field, std::move(merkle_tree_blob),
             eid_output, rt_output, merkle_tree_output);
     logln("Marshalling finished." );
 }
 
+// Co-path of one voter, all a voter needs of the Merkle tree to cast a ballot. Its blob is the leaf, the
+// (arity - 1) * tree_depth siblings from the leaves up, each group in tree order, and the root, every node packed
+// the same way as in the Merkle tree blob. It is O(tree_depth) long, whatever the number of voters.
+class merkle_copath {
+public:
+    using merkle_proof_type = voting_circuit::merkle_proof_type;
+    using node_type = encrypted_input_policy::merkle_node_type;
+
+    constexpr static std::size_t arity = encrypted_input_policy::arity;
+    constexpr static std::size_t digest_bits = node_type::bits;
+    constexpr static std::size_t node_octets = node_type::octets;
+
+    static std::size_t blob_size(std::size_t tree_depth) {
+        return ((arity - 1) * tree_depth + 2) * node_octets;
+    }
+
+    merkle_copath(std::size_t tree_depth, std::size_t leaf_idx, const std::vector<std::uint8_t> &copath_blob) :
+        leaf_idx(leaf_idx) {
+        BOOST_ASSERT_MSG(leaf_idx < (std::size_t(1) << tree_depth), "Leaf index is out of the tree!");
+        BOOST_ASSERT_MSG(copath_blob.size() == blob_size(tree_depth),
+                         "Merkle co-path blob size doesn't match the tree depth!");
+
+        auto node = [&](std::size_t node_idx) {
+            return node_type::from_octets(copath_blob.data() + node_idx * node_octets).to_bits();
+        };
+
+        leaf_digest = node(0);
+        root_digest = node(blob_size(tree_depth) / node_octets - 1);
+
+        typename merkle_proof_type::path_type path;
+        path.reserve(tree_depth);
+        std::size_t sibling_idx = 1;
+        std::size_t idx = leaf_idx;
+        for (std::size_t level = 0; level < tree_depth; ++level) {
+            typename merkle_proof_type::layer_type layer;
+            for (std::size_t i = 0, j = 0; i < arity; ++i) {
+                if (i != idx % arity) {
+                    layer[j++] = typename merkle_proof_type::path_element_t(node(sibling_idx++), i);
+                }
+            }
+            path.emplace_back(layer);
+            idx /= arity;
+        }
+        path_proof = merkle_proof_type(leaf_idx, root_digest, path);
+    }
+
+    std::size_t leaf_index() const {
+        return leaf_idx;
+    }
+
+    const std::vector<bool> &leaf() const {
+        return leaf_digest;
+    }
+
+    const std::vector<bool> &root() const {
+        return root_digest;
+    }
+
+    // Same copath as merkle_proof_type(tree, leaf_index()) gives for the full tree.
+    const merkle_proof_type &proof() const {
+        return path_proof;
+    }
+
+private:
+    std::size_t leaf_idx;
+    std::vector<bool> leaf_digest;
+    std::vector<bool> root_digest;
+    merkle_proof_type path_proof;
+};
+
+// View of the Merkle tree blob of either format, see merkle_tree_format. Nodes stay packed, a copath only unpacks its
+// O(tree_depth) nodes instead of the whole tree.
+class merkle_tree_view {
+public:
+    constexpr static std::size_t arity = merkle_copath::arity;
+    constexpr static std::size_t digest_bits = merkle_copath::digest_bits;
+    constexpr static std::size_t node_octets = merkle_copath::node_octets;
+
+    merkle_tree_view(std::size_t tree_depth, std::vector<std::uint8_t> merkle_tree_blob) :
+        tree_depth(tree_depth), leaves_number(std::size_t(1) << tree_depth), blob(std::move(merkle_tree_blob)) {
+        std::size_t dense_size = containers::detail::merkle_tree_length(leaves_number, arity) * node_octets;
+        sparse = blob.size() != dense_size && blob.size() >= sparse_merkle_tree_header_octets &&
+                 std::equal(sparse_merkle_tree_magic.begin(), sparse_merkle_tree_magic.end(), blob.begin());
+
+        std::size_t stored_leaves = leaves_number;
+        std::size_t offset = 0;
+        if (sparse) {
+            stored_leaves = 0;
+            for (std::size_t i = 0; i < sparse_merkle_tree_leaves_octets; ++i) {
+                stored_leaves = (stored_leaves << 8) | blob[sparse_merkle_tree_magic.size() + i];
+            }
+            BOOST_ASSERT_MSG(stored_leaves <= leaves_number, "Sparse Merkle tree holds more leaves than the tree depth allows!");
+            offset = sparse_merkle_tree_header_octets;
+        }
+
+        for (std::size_t level = 0, row_size = stored_leaves; level <= tree_depth; ++level) {
+            rows_begins.emplace_back(offset);
+            rows_sizes.emplace_back(row_size);
+            offset += row_size * node_octets;
+            row_size = (row_size + arity - 1) / arity;
+        }
+        empty_digests_begin = offset;
+        if (sparse) {
+            offset += (tree_depth + 1) * node_octets;
+        }
+        BOOST_ASSERT_MSG(blob.size() == offset, "Merkle tree blob size doesn't match the tree depth!");
+    }
+
+    std::size_t depth() const {
+        return tree_depth;
+    }
+
+    std::size_t leaves() const {
+        return leaves_number;
+    }
+
+    bool is_sparse() const {
+        return sparse;
+    }
+
+    // Node idx of the level, counting from the leaves. Empty subtrees of a sparse tree share one node per level.
+    const std::uint8_t *node_data(std::size_t level, std::size_t idx) const {
+        BOOST_ASSERT(level <= tree_depth && idx < (leaves_number >> level));
+        if (idx < rows_sizes[level]) {
+            return blob.data() + rows_begins[level] + idx * node_octets;
+        }
+        BOOST_ASSERT(sparse);
+        return blob.data() + empty_digests_begin + level * node_octets;
+    }
+
+    merkle_copath::node_type node_digest(std::size_t level, std::size_t idx) const {
+        return merkle_copath::node_type::from_octets(node_data(level, idx));
+    }
+
+    std::vector<bool> node(std::size_t level, std::size_t idx) const {
+        return node_digest(level, idx).to_bits();
+    }
+
+    std::vector<bool> leaf(std::size_t leaf_idx) const {
+        return node(0, leaf_idx);
+    }
+
+    std::vector<bool> root() const {
+        return node(tree_depth, 0);
+    }
+
+    // Number of leaves the blob stores, the rest being empty subtrees of a sparse tree.
+    std::size_t stored_leaves() const {
+        return rows_sizes[0];
+    }
+
+    const std::vector<std::uint8_t> &data() const {
+        return blob;
+    }
+
+    std::vector<std::uint8_t> release() {
+        return std::move(blob);
+    }
+
+    void set_node(std::size_t level, std::size_t idx, const std::uint8_t *node) {
+        BOOST_ASSERT_MSG(idx < rows_sizes[level], "Node of a sparse tree is not stored, grow the tree first!");
+        std::copy(node, node + node_octets, blob.begin() + rows_begins[level] + idx * node_octets);
+    }
+
+    // Makes a sparse tree store its first leaves_stored leaves and their ancestors. New nodes are copies of the empty
+    // subtree digests, so the tree and its root stay the same.
+    void grow(std::size_t leaves_stored) {
+        BOOST_ASSERT(leaves_stored <= leaves_number);
+        if (!sparse || leaves_stored <= rows_sizes[0]) {
+            return;
+        }
+
+        std::vector<std::uint8_t> grown_blob(blob.begin(), blob.begin() + sparse_merkle_tree_magic.size());
+        for (std::size_t i = 0; i < sparse_merkle_tree_leaves_octets; ++i) {
+            grown_blob.emplace_back(std::uint8_t(leaves_stored >> (8 * (sparse_merkle_tree_leaves_octets - 1 - i))));
+        }
+        std::vector<std::size_t> grown_rows_begins;
+        std::vector<std::size_t> grown_rows_sizes;
+        for (std::size_t level = 0, row_size = leaves_stored; level <= tree_depth; ++level) {
+            grown_rows_begins.emplace_back(grown_blob.size());
+            grown_rows_sizes.emplace_back(row_size);
+            auto row_begin = blob.begin() + rows_begins[level];
+            grown_blob.insert(grown_blob.end(), row_begin, row_begin + rows_sizes[level] * node_octets);
+            for (std::size_t idx = rows_sizes[level]; idx < row_size; ++idx) {
+                grown_blob.insert(grown_blob.end(), node_data(level, idx), node_data(level, idx) + node_octets);
+            }
+            row_size = (row_size + arity - 1) / arity;
+        }
+        std::size_t grown_empty_digests_begin = grown_blob.size();
+        grown_blob.insert(grown_blob.end(), blob.begin() + empty_digests_begin, blob.end());
+
+        blob = std::move(grown_blob);
+        rows_begins = std::move(grown_rows_begins);
+        rows_sizes = std::move(grown_rows_sizes);
+        empty_digests_begin = grown_empty_digests_begin;
+    }
+
+    // Co-path blob of the leaf, see merkle_copath. Nodes are copied as they are, without unpacking.
+    std::vector<std::uint8_t> copath(std::size_t leaf_idx) const {
+        BOOST_ASSERT_MSG(leaf_idx < leaves_number, "Leaf index is out of the tree!");
+        std::vector<std::uint8_t> copath_blob;
+        copath_blob.reserve(merkle_copath::blob_size(tree_depth));
+        auto append_node = [&](std::size_t level, std::size_t idx) {
+            copath_blob.insert(copath_blob.end(), node_data(level, idx), node_data(level, idx) + node_octets);
+        };
+
+        append_node(0, leaf_idx);
+        std::size_t idx = leaf_idx;
+        for (std::size_t level = 0; level < tree_depth; ++level) {
+            std::size_t group_begin = idx - idx % arity;
+            for (std::size_t i = 0; i < arity; ++i) {
+                if (group_begin + i != idx) {
+                    append_node(level, group_begin + i);
+                }
+            }
+            idx /= arity;
+        }
+        append_node(tree_depth, 0);
+
+        return copath_blob;
+    }
+
+private:
+    std::size_t tree_depth;
+    std::size_t leaves_number;
+    std::vector<std::uint8_t> blob;
+    bool sparse;
+    std::vector<std::size_t> rows_begins;
+    std::vector<std::size_t> rows_sizes;
+    std::size_t empty_digests_begin;
+};
+
+// Server side of the co-path distribution: cuts the co-path of the voter out of the Merkle tree blob, so the voter
+// doesn't have to download the whole tree.
+std::vector<std::uint8_t> extract_copath(std::size_t tree_depth, const std::vector<std::uint8_t> &merkle_tree_blob,
+                                         std::size_t voter_idx) {
+    return merkle_tree_view(tree_depth, merkle_tree_blob).copath(voter_idx);
+}
+
+// Delta of a Merkle tree update: the big-endian index of the updated leaf, then the new nodes of its path from the
+// leaf up to the root, packed as in the Merkle tree blob. Replicas of the tree apply it with apply_merkle_tree_delta
+// instead of downloading the whole tree again.
+constexpr std::size_t merkle_tree_delta_index_octets = 8;
+
+// Registers the public key of the voter at voter_idx, replacing whatever leaf was there, and rehashes only the
+// O(tree_depth) nodes of its path. Outputs the new rt and the delta of the update. Sparse trees grow to store the new
+// leaf if needed, empty subtrees they grow into are copied rather than rehashed.
+void update_merkle_tree_leaf(std::size_t tree_depth, std::vector<std::uint8_t> &merkle_tree_blob,
+                             std::size_t voter_idx, const std::vector<std::uint8_t> &public_key_blob,
+                             std::vector<std::uint8_t> &rt_output, std::vector<std::uint8_t> &delta_output) {
+    using merkle_hash_type = encrypted_input_policy::merkle_hash_type;
+    using node_type = encrypted_input_policy::merkle_node_type;
+    constexpr std::size_t arity = merkle_tree_view::arity;
+
+    merkle_tree_view tree(tree_depth, std::move(merkle_tree_blob));
+    BOOST_ASSERT_MSG(voter_idx < tree.leaves(), "Voter index should be less than number of participants!");
+    // Grow geometrically and only past the stored leaves, so appending voters one by one rebuilds the blob
+    // O(log(voters)) times only, O(1) amortized per voter.
+    if (voter_idx >= tree.stored_leaves()) {
+        tree.grow(std::min(tree.leaves(), std::max(voter_idx + 1, 2 * tree.stored_leaves())));
+    }
+
+    auto public_key = marshaling_policy::deserialize_digest<encrypted_input_policy::public_key_bits>(public_key_blob);
+    node_type node = hash_digest<merkle_hash_type>(public_key.to_bits());
+
+    delta_output.assign(merkle_tree_delta_index_octets, 0);
+    for (std::size_t i = 0; i < merkle_tree_delta_index_octets; ++i) {
+        delta_output[merkle_tree_delta_index_octets - 1 - i] = std::uint8_t(voter_idx >> (8 * i));
+    }
+
+    std::size_t idx = voter_idx;
+    for (std::size_t level = 0; level <= tree_depth; ++level) {
+        if (level > 0) {
+            std::vector<bool> children_bits;
+            children_bits.reserve(arity * node_type::bits);
+            for (std::size_t j = 0; j < arity; ++j) {
+                tree.node_digest(level - 1, idx * arity + j).append_bits(children_bits);
+            }
+            node = hash_digest<merkle_hash_type>(children_bits);
+        }
+
+        tree.set_node(level, idx, node.data());
+        delta_output.insert(delta_output.end(), node.data(), node.data() + node_type::octets);
+        idx /= arity;
+    }
+
+    rt_output = marshaling_policy::serialize_scalar_vector(
+            marshaling_policy::get_multi_field_element_from_bits(node.to_bits()));
+    merkle_tree_blob = tree.release();
+}
+
+// Applies the delta of update_merkle_tree_leaf to a replica of the tree and outputs the new rt. Nothing is hashed.
+void apply_merkle_tree_delta(std::size_t tree_depth, std::vector<std::uint8_t> &merkle_tree_blob,
+                             const std::vector<std::uint8_t> &delta_blob, std::vector<std::uint8_t> &rt_output) {
+    constexpr std::size_t arity = merkle_tree_view::arity;
+    constexpr std::size_t node_octets = merkle_tree_view::node_octets;
+
+    BOOST_ASSERT_MSG(delta_blob.size() == merkle_tree_delta_index_octets + (tree_depth + 1) * node_octets,
+                     "Merkle tree delta size doesn't match the tree depth!");
+    std::size_t voter_idx = 0;
+    for (std::size_t i = 0; i < merkle_tree_delta_index_octets; ++i) {
+        voter_idx = (voter_idx << 8) | delta_blob[i];
+    }
+
+    merkle_tree_view tree(tree_depth, std::move(merkle_tree_blob));
+    BOOST_ASSERT_MSG(voter_idx < tree.leaves(), "Voter index should be less than number of participants!");
+    // Grow geometrically and only past the stored leaves, so appending voters one by one rebuilds the blob
+    // O(log(voters)) times only, O(1) amortized per voter.
+    if (voter_idx >= tree.stored_leaves()) {
+        tree.grow(std::min(tree.leaves(), std::max(voter_idx + 1, 2 * tree.stored_leaves())));
+    }
+
+    std::size_t idx = voter_idx;
+    for (std::size_t level = 0; level <= tree_depth; ++level) {
+        tree.set_node(level, idx, delta_blob.data() + merkle_tree_delta_index_octets + level * node_octets);
+        idx /= arity;
+    }
+
+    rt_output = marshaling_policy::serialize_scalar_vector(
+            marshaling_policy::get_multi_field_element_from_bits(tree.root()));
+    merkle_tree_blob = tree.release();
+}
+
 // #define DEBUG_VERIFY_BALLOT
 
+// Election context of the vote phase. Everything which is the same for all the ballots of an election (CRS, pk_eid,
+// eid, rt and Merkle tree) is deserialized once on construction, so casting a vote only costs witness generation
+// and proving.
+class prover_session {
+public:
+    using scalar_field_value_type = typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type;
+
+    prover_session(std::size_t tree_depth, std::size_t eid_bits,
+                   const std::vector<std::uint8_t> &merkle_tree_blob,
+                   blob_view rt_blob,
+                   blob_view eid_blob,
+                   blob_view pk_eid_blob,
+                   blob_view proving_key_blob,
+                   blob_view verification_key_blob) :
+        prover_session(tree_depth, eid_bits, rt_blob, eid_blob, pk_eid_blob, proving_key_blob,
+                       verification_key_blob) {
+        tree.emplace(tree_depth, merkle_tree_blob);
+        BOOST_ASSERT_MSG(marshaling_policy::get_multi_field_element_from_bits(tree->root()) == rt_field,
+                         "Merkle tree root doesn't match rt!");
+    }
+
+    // Session of a voter holding its co-path only, ballots are cast with cast_vote(copath, ...).
+    prover_session(std::size_t tree_depth, std::size_t eid_bits,
+                   blob_view rt_blob,
+                   blob_view eid_blob,
+                   blob_view pk_eid_blob,
+                   blob_view proving_key_blob,
+                   blob_view verification_key_blob) :
+        tree_depth(tree_depth),
+        eid_bits(eid_bits),
+        rt_field(marshaling_policy::deserialize_scalar_vector(rt_blob)),
+        pk_eid(marshaling_policy::deserialize_pk_eid(pk_eid_blob)),
+        gg_keypair(crs_cache::acquire(proving_key_blob, verification_key_blob)) {
+        auto eid_field = marshaling_policy::deserialize_scalar_vector(eid_blob);
+        logln("Finished deserialization of rt,eid,pk_eid,proving_key,verification_key");
+
+        eid.resize(eid_bits);
+        std::size_t chunk_size = encrypted_input_policy::field_type::value_bits - 1;
+        for(std::size_t i = 0; i < eid_bits; ++i) {
+            eid[i] = nil::crypto3::multiprecision::bit_test(eid_field[i/chunk_size].data, i%chunk_size);
+        }
+
+        // Generate the voting R1CS up front, so the first ballot doesn't pay for it.
+        voting_circuit_pool::acquire(tree_depth, eid_bits);
+    }
+
+    void cast_vote(std::size_t voter_idx, std::size_t vote, const std::vector<std::uint8_t> &sk_blob,
+                   std::vector<std::uint8_t> &proof_blob, std::vector<std::uint8_t> &pinput_blob,
+                   std::vector<std::uint8_t> &ct_blob, std::vector<std::uint8_t> &sn_blob,
+                   witness_check_level check_level = witness_check_level::final_only) const {
+        BOOST_ASSERT_MSG(tree, "Session was created without Merkle tree, cast votes with voters' co-paths!");
+        std::size_t participants_number = 1 << tree_depth;
+        BOOST_ASSERT_MSG(participants_number > voter_idx, "Voter index should be lass than number of participants!");
+
+        logln("Voter with index " , voter_idx , " generates its merkle copath..." );
+        merkle_copath copath(tree_depth, voter_idx, tree->copath(voter_idx));
+        logln("Copath generated." );
+
+        cast_vote(copath, vote, sk_blob, proof_blob, pinput_blob, ct_blob, sn_blob, check_level);
+    }
+
+    void cast_vote(const merkle_copath &copath, std::size_t vote, const std::vector<std::uint8_t> &sk_blob,
+                   std::vector<std::uint8_t> &proof_blob, std::vector<std::uint8_t> &pinput_blob,
+                   std::vector<std::uint8_t> &ct_blob, std::vector<std::uint8_t> &sn_blob,
+                   witness_check_level check_level = witness_check_level::final_only) const {
+        std::vector<bool> sk =
+                marshaling_policy::deserialize_digest<encrypted_input_policy::secret_key_bits>(sk_blob).to_bits();
+
+        std::size_t proof_idx = copath.leaf_index();
+        BOOST_ASSERT_MSG(encrypted_input_policy::msg_size > vote, "Vote should be less than number of options!");
+        BOOST_ASSERT_MSG(marshaling_policy::get_multi_field_element_from_bits(copath.root()) == rt_field,
+                         "Merkle co-path root doesn't match rt!");
+
+        logln("Voter " , proof_idx , " generate encrypted ballot" , "\n");
+
+        std::vector<bool> m(encrypted_input_policy::msg_size, false);
+        m[vote] = true;
+        log("Voter " , proof_idx , " is willing to vote with the following ballot: { ");
+        for (auto m_i : m) {
+            log(int(m_i));
+        }
+        logln(" }" );
+        std::vector<typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type> m_field;
+        m_field.reserve(m.size());
+        for (const auto m_i : m) {
+            m_field.emplace_back(std::size_t(m_i));
+        }
+
+        std::vector<bool> eid_sk;
+        eid_sk.reserve(eid.size() + sk.size());
+        eid_sk.insert(eid_sk.end(), eid.begin(), eid.end());
+        eid_sk.insert(eid_sk.end(), sk.begin(), sk.end());
+        std::vector<bool> sn = hash<encrypted_input_policy::hash_type>(eid_sk);
+        log("Sender has following serial number (sn) in current session: ");
+        for (auto i : sn) {
+            log(int(i));
+        }
+        logln();
+
+        auto circuit = voting_circuit_pool::acquire(tree_depth, eid_bits);
+        circuit->generate_witness(copath.proof(), copath.root(), m, eid, sk, sn, check_level);
+
+        logln("Voter " , proof_idx , " generates its vote consisting of proof and cipher text..." );
+        random::algebraic_random_device<typename encrypted_input_policy::pairing_curve_type::scalar_field_type> d;
+        typename encrypted_input_policy::encryption_scheme_type::cipher_type cipher_text =
+                encrypt<encrypted_input_policy::encryption_scheme_type,
+        modes::verifiable_encryption<encrypted_input_policy::encryption_scheme_type>>(
+                m_field, {d(), pk_eid, *gg_keypair, circuit->bp.primary_input(), circuit->bp.auxiliary_input()});
+        logln("Vote generated." );
+
+        logln("Rerandomization of the cipher text and proof started..." );
+        std::vector<typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type> rnd_rerandomization;
+        for (std::size_t i = 0; i < 3; ++i) {
+            rnd_rerandomization.emplace_back(d());
+        }
+        typename encrypted_input_policy::encryption_scheme_type::cipher_type rerand_cipher_text =
+                rerandomize<encrypted_input_policy::encryption_scheme_type>(rnd_rerandomization, cipher_text.first,
+                                                                            {pk_eid, *gg_keypair, cipher_text.second});
+        logln("Rerandomization finished." );
+
+        logln("Voter " , proof_idx , " marshalling started..." );
+        std::size_t eid_offset = circuit->eid_offset();
+        std::size_t sn_offset = circuit->sn_offset();
+        std::size_t rt_offset = circuit->rt_offset();
+        typename encrypted_input_policy::proof_system::primary_input_type pinput = circuit->bp.primary_input();
+        marshaling_policy::serialize_data(
+                proof_idx, rerand_cipher_text.second,
+                typename encrypted_input_policy::proof_system::primary_input_type {std::cbegin(pinput) + eid_offset,
+                                                                                   std::cend(pinput)},
+                rerand_cipher_text.first,
+                typename encrypted_input_policy::proof_system::primary_input_type {std::cbegin(pinput) + sn_offset,
+                                                                                   std::cbegin(pinput) + rt_offset},
+                proof_blob, pinput_blob, ct_blob, sn_blob);
+        logln("Marshalling finished." );
+#ifdef DEBUG_VERIFY_BALLOT
+        logln("Sender verifies rerandomized encrypted ballot and proof..." );
+        bool enc_verification_ans = verify_encryption<encrypted_input_policy::encryption_scheme_type>(
+            rerand_cipher_text.first,
+            {pk_eid, gg_keypair->second, rerand_cipher_text.second,
+             typename encrypted_input_policy::proof_system::primary_input_type {std::cbegin(pinput) + m.size(),
+                                                                            std::cend(pinput)}});
+        BOOST_ASSERT(enc_verification_ans);
+        logln("Encryption verification of rerandomazed cipher text and proof finished." );
+#else
+        logln("Skipping ballot verification");
+#endif
+    }
+
+private:
+    std::size_t tree_depth;
+    std::size_t eid_bits;
+    std::optional<merkle_tree_view> tree;
+    std::vector<scalar_field_value_type> rt_field;
+    std::vector<bool> eid;
+    marshaling_policy::elgamal_public_key_type pk_eid;
+    std::shared_ptr<const crs_cache::keypair_type> gg_keypair;
+};
+
+// Ballot of the batch vote phase: voter index, vote and voter's secret key blob.
+using ballot_request_type = std::tuple<std::size_t, std::size_t, std::vector<std::uint8_t>>;
+
+// Casts all the ballots against one election context, proving up to threads_number of them at once (zero meaning one
+// per core). Output blobs are in the order of the requests. In MULTICORE builds every ballot is proved on
+// prover_threads OpenMP threads, so threads_number * prover_threads should not exceed the number of cores. Zero
+// prover_threads shares the cores among the workers, at least one thread each.
+void generate_votes_batch(const prover_session &session, const std::vector<ballot_request_type> &ballots,
+                          std::vector<std::vector<std::uint8_t>> &proof_blobs,
+                          std::vector<std::vector<std::uint8_t>> &pinput_blobs,
+                          std::vector<std::vector<std::uint8_t>> &ct_blobs,
+                          std::vector<std::vector<std::uint8_t>> &sn_blobs,
+                          std::size_t threads_number = 0, std::size_t prover_threads = 1,
+                          witness_check_level check_level = witness_check_level::final_only) {
+    proof_blobs.assign(ballots.size(), {});
+    pinput_blobs.assign(ballots.size(), {});
+    ct_blobs.assign(ballots.size(), {});
+    sn_blobs.assign(ballots.size(), {});
+
+    if (prover_threads == 0) {
+        std::size_t workers_number = std::max<std::size_t>(
+                std::min(resolve_threads_number(threads_number), ballots.size()), 1);
+        prover_threads = std::max<std::size_t>(resolve_threads_number(0) / workers_number, 1);
+    }
+#ifdef MULTICORE
+    // The calling thread is one of the workers, its own setting is put back afterwards.
+    int caller_prover_threads = omp_get_max_threads();
+#endif
+    parallel_for(ballots.size(), threads_number, [&](std::size_t i) {
+        set_current_thread_prover_threads(prover_threads);
+        const auto &[voter_idx, vote, sk_blob] = ballots[i];
+        session.cast_vote(voter_idx, vote, sk_blob, proof_blobs[i], pinput_blobs[i], ct_blobs[i], sn_blobs[i],
+                          check_level);
+    });
+#ifdef MULTICORE
+    omp_set_num_threads(caller_prover_threads);
+#endif
+}
+
 void process_encrypted_input_mode_vote_phase(
         std::size_t tree_depth, std::size_t eid_bits, std::size_t voter_idx, std::size_t vote, const std::vector<std::uint8_t> &merkle_tree_blob,
-        const std::vector<std::uint8_t> &rt_blob,
-        const std::vector<std::uint8_t> &eid_blob,
+        blob_view rt_blob,
+        blob_view eid_blob,
         const std::vector<std::uint8_t> &sk_blob,
-        const std::vector<std::uint8_t> &pk_eid_blob,
-        const std::vector<std::uint8_t> &proving_key_blob,
-        const std::vector<std::uint8_t> &verification_key_blob,
+        blob_view pk_eid_blob,
+        blob_view proving_key_blob,
+        blob_view verification_key_blob,
         std::vector<std::uint8_t> &proof_blob, std::vector<std::uint8_t> &pinput_blob, std::vector<std::uint8_t> &ct_blob,
-        std::vector<std::uint8_t> &sn_blob) {
-    using scalar_field_value_type = typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type;
+        std::vector<std::uint8_t> &sn_blob,
+        witness_check_level check_level = witness_check_level::final_only) {
+    prover_session session(tree_depth, eid_bits, merkle_tree_blob, rt_blob, eid_blob, pk_eid_blob, proving_key_blob,
+                           verification_key_blob);
+    session.cast_vote(voter_idx, vote, sk_blob, proof_blob, pinput_blob, ct_blob, sn_blob, check_level);
+}
+
+// Vote phase of a voter which downloaded its co-path (see extract_copath) instead of the whole Merkle tree.
+void process_encrypted_input_mode_vote_phase_copath(
+        std::size_t tree_depth, std::size_t eid_bits, std::size_t voter_idx, std::size_t vote,
+        const std::vector<std::uint8_t> &copath_blob,
+        blob_view rt_blob,
+        blob_view eid_blob,
+        const std::vector<std::uint8_t> &sk_blob,
+        blob_view pk_eid_blob,
+        blob_view proving_key_blob,
+        blob_view verification_key_blob,
+        std::vector<std::uint8_t> &proof_blob, std::vector<std::uint8_t> &pinput_blob, std::vector<std::uint8_t> &ct_blob,
+        std::vector<std::uint8_t> &sn_blob,
+        witness_check_level check_level = witness_check_level::final_only) {
+    prover_session session(tree_depth, eid_bits, rt_blob, eid_blob, pk_eid_blob, proving_key_blob,
+                           verification_key_blob);
+    session.cast_vote(merkle_copath(tree_depth, voter_idx, copath_blob), vote, sk_blob, proof_blob, pinput_blob,
+                      ct_blob, sn_blob, check_level);
+}
+
+// Verifies the ballots published on the bulletin board: the proof of every ballot is checked against its cipher text
+// with verify_encryption, and its primary input must carry the eid and rt of this election. Ballots are spread over
+// the worker pool. Returns the verdict for every ballot, in the order of the ballots. Every ballot costs its own
+// pairings and final exponentiation, there is no batch check of many ballots with a random linear combination.
+std::vector<bool> process_encrypted_input_mode_vote_verify_phase(
+        const std::vector<std::vector<std::uint8_t>> &proof_blobs,
+        const std::vector<std::vector<std::uint8_t>> &pinput_blobs,
+        const std::vector<std::vector<std::uint8_t>> &ct_blobs,
+        blob_view eid_blob,
+        blob_view rt_blob,
+        blob_view pk_eid_blob,
+        blob_view verification_key_blob,
+        std::size_t threads_number = 0) {
+    BOOST_ASSERT_MSG(proof_blobs.size() == pinput_blobs.size() && proof_blobs.size() == ct_blobs.size(),
+                     "Every ballot should consist of a proof, a primary input and a cipher text!");
 
-    auto tree = marshaling_policy::deserialize_merkle_tree(tree_depth, merkle_tree_blob);
-    auto admin_rt_field = marshaling_policy::deserialize_scalar_vector(rt_blob);
     auto eid_field = marshaling_policy::deserialize_scalar_vector(eid_blob);
-    auto sk = marshaling_policy::deserialize_bitarray<encrypted_input_policy::secret_key_bits>(sk_blob);
+    auto rt_field = marshaling_policy::deserialize_scalar_vector(rt_blob);
     auto pk_eid = marshaling_policy::deserialize_pk_eid(pk_eid_blob);
+    auto vk_crs = marshaling_policy::deserialize_vk_crs(verification_key_blob);
+    logln("Finished deserialization of eid,rt,pk_eid,verification_key");
+
+    // Primary input of a ballot is eid, sn and rt packed into field elements, in that order, as in voting_circuit.
+    const std::size_t chunk_size = encrypted_input_policy::field_type::value_bits - 1;
+    const std::size_t sn_size = (encrypted_input_policy::hash_component::digest_bits + (chunk_size - 1)) / chunk_size;
+    const std::size_t pinput_size = eid_field.size() + sn_size + rt_field.size();
+    // SAVER cipher text of msg_size slots: X_0, X_1, ..., X_msg_size and psi.
+    const std::size_t ct_size = encrypted_input_policy::msg_size + 2;
+
+    // Written concurrently, hence not std::vector<bool>.
+    std::vector<std::uint8_t> verdicts(proof_blobs.size(), 0);
+    parallel_for(proof_blobs.size(), threads_number, [&](std::size_t ballot_idx) {
+        // Ballots come from the bulletin board, anything malformed is rejected before it reaches the verifier.
+        nil::marshalling::status_type pinput_status, ct_status, proof_status;
+        auto pinput = marshaling_policy::deserialize_scalar_vector(pinput_blobs[ballot_idx], &pinput_status);
+        auto ct = marshaling_policy::deserialize_ct(ct_blobs[ballot_idx], &ct_status);
+        auto proof = marshaling_policy::deserialize_proof(proof_blobs[ballot_idx], &proof_status);
+        if (pinput_status != nil::marshalling::status_type::success ||
+            ct_status != nil::marshalling::status_type::success ||
+            proof_status != nil::marshalling::status_type::success || std::size(ct) != ct_size) {
+            logln("Ballot " , ballot_idx , " is malformed" );
+            return;
+        }
+        if (pinput.size() != pinput_size ||
+            !std::equal(eid_field.begin(), eid_field.end(), pinput.begin()) ||
+            !std::equal(rt_field.begin(), rt_field.end(), pinput.end() - rt_field.size())) {
+            logln("Ballot " , ballot_idx , " doesn't belong to this election" );
+            return;
+        }
+        verdicts[ballot_idx] = verify_encryption<encrypted_input_policy::encryption_scheme_type>(
+            ct, {pk_eid, vk_crs, proof, pinput});
+        if (!verdicts[ballot_idx]) {
+            logln("Ballot " , ballot_idx , " verification failed" );
+        }
+    });
 
-    typename encrypted_input_policy::proof_system::keypair_type gg_keypair = {
-            marshaling_policy::deserialize_pk_crs(proving_key_blob),
-            marshaling_policy::deserialize_vk_crs(verification_key_blob)};
+    std::size_t valid_ballots = std::count(verdicts.begin(), verdicts.end(), 1);
+    logln("Verified ballots: " , valid_ballots , " valid out of " , verdicts.size() );
+    return std::vector<bool>(verdicts.begin(), verdicts.end());
+}
 
-    logln("Finished deserialization of merkle_tree,rt,eid,sk,pk_eid,proving_key,verification_key");
+// Adds the encrypted ballot ct to ct_sum slot by slot. Points fresh from deserialization are normalized (Z = 1), for
+// those the cheaper mixed addition is used; anything else, e.g. another partial sum, goes through the full addition.
+void add_ct(typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type &ct_sum,
+            const typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type &ct) {
+    BOOST_ASSERT_MSG(std::size(ct_sum) == std::size(ct), "Wrong size of the ct!");
+    for (std::size_t i = 0; i < std::size(ct); ++i) {
+        using coordinate_type = typename std::decay<decltype(ct[i].Z)>::type;
+        if (ct[i].Z == coordinate_type::one()) {
+            ct_sum[i] = ct_sum[i].mixed_add(ct[i]);
+        } else {
+            ct_sum[i] = ct_sum[i] + ct[i];
+        }
+    }
+}
 
-    std::size_t participants_number = 1 << tree_depth;
-    std::vector<bool> eid;
-    eid.resize(eid_bits);
-    std::size_t chunk_size = encrypted_input_policy::field_type::value_bits - 1;
-    for(std::size_t i = 0; i < eid_bits; ++i) {
-        eid[i] = nil::crypto3::multiprecision::bit_test(eid_field[i/chunk_size].data, i%chunk_size);
+// Sums the points with affine additions, adding them pairwise round by round. Every round shares one field inversion
+// among all its additions (Montgomery's trick), so n normalized points (Z = 1) cost about log(n) inversions and a few
+// multiplications per addition, against a full projective addition each. Points at infinity are skipped, points which
+// aren't normalized and pairs sharing x (doubling or opposite points) are added projectively.
+template<typename PointType>
+PointType sum_points_batched(const std::vector<PointType> &points) {
+    using coordinate_type = typename std::decay<decltype(std::declval<PointType>().X)>::type;
+
+    PointType rest = PointType::zero();
+    auto add_normalized = [&](const PointType &point) {
+        rest = rest.is_zero() ? point : rest.mixed_add(point);
+    };
+
+    std::vector<PointType> affine;
+    affine.reserve(points.size());
+    for (const auto &point : points) {
+        if (point.is_zero()) {
+            continue;
+        }
+        if (point.Z == coordinate_type::one()) {
+            affine.emplace_back(point);
+        } else {
+            rest = rest + point;
+        }
     }
 
-    std::size_t proof_idx = voter_idx;
-    BOOST_ASSERT_MSG(participants_number > proof_idx, "Voter index should be lass than number of participants!");
-
-    logln("Voter " , proof_idx , " generate encrypted ballot" , "\n");
-
-    logln("Voter with index " , proof_idx , " generates its merkle copath..." );
-    std::vector<scalar_field_value_type> rt_field = marshaling_policy::get_multi_field_element_from_bits(tree.root());
-    BOOST_ASSERT(rt_field == admin_rt_field);
-    containers::merkle_proof<encrypted_input_policy::merkle_hash_type, encrypted_input_policy::arity> path(tree,
-                                                                                                           proof_idx);
-    logln("Copath generated." );
-    auto tree_pk_leaf = tree[proof_idx];
-
-    std::vector<bool> m(encrypted_input_policy::msg_size, false);
-    m[vote] = true;
-    log("Voter " , proof_idx , " is willing to vote with the following ballot: { ");
-    for (auto m_i : m) {
-        log(int(m_i));
-    }
-    logln(" }" );
-    std::vector<typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type> m_field;
-    m_field.reserve(m.size());
-    for (const auto m_i : m) {
-        m_field.emplace_back(std::size_t(m_i));
-    }
-
-    std::vector<bool> eid_sk;
-    std::copy(std::cbegin(eid), std::cend(eid), std::back_inserter(eid_sk));
-    std::copy(std::cbegin(sk), std::cend(sk), std::back_inserter(eid_sk));
-    std::vector<bool> sn = hash<encrypted_input_policy::hash_type>(eid_sk);
-    log("Sender has following serial number (sn) in current session: ");
-    for (auto i : sn) {
-        log(int(i));
+    std::vector<coordinate_type> inverses;
+    std::vector<coordinate_type> prefix_products;
+    std::vector<PointType> sums;
+    while (affine.size() > 1) {
+        std::size_t pairs_number = affine.size() / 2;
+        inverses.resize(pairs_number);
+        prefix_products.resize(pairs_number);
+
+        // inverses[i] is 1 / (x2 - x1) of the pair, or 1 for a pair sharing x.
+        coordinate_type product = coordinate_type::one();
+        for (std::size_t i = 0; i < pairs_number; ++i) {
+            coordinate_type denominator = affine[2 * i + 1].X - affine[2 * i].X;
+            inverses[i] = denominator == coordinate_type::zero() ? coordinate_type::one() : denominator;
+            prefix_products[i] = product;
+            product = product * inverses[i];
+        }
+        coordinate_type inverse = product.inversed();
+        for (std::size_t i = pairs_number; i-- > 0;) {
+            coordinate_type denominator = inverses[i];
+            inverses[i] = inverse * prefix_products[i];
+            inverse = inverse * denominator;
+        }
+
+        sums.clear();
+        for (std::size_t i = 0; i < pairs_number; ++i) {
+            const PointType &first = affine[2 * i];
+            const PointType &second = affine[2 * i + 1];
+            if (first.X == second.X) {
+                add_normalized(first);
+                add_normalized(second);
+                continue;
+            }
+            coordinate_type lambda = (second.Y - first.Y) * inverses[i];
+            coordinate_type x = lambda.squared() - first.X - second.X;
+            coordinate_type y = lambda * (first.X - x) - first.Y;
+            sums.emplace_back(x, y, coordinate_type::one());
+        }
+        if (affine.size() % 2) {
+            sums.emplace_back(affine.back());
+        }
+        affine.swap(sums);
     }
-    logln();
 
-    components::blueprint<encrypted_input_policy::field_type> bp;
-    components::block_variable<encrypted_input_policy::field_type> m_block(bp, encrypted_input_policy::msg_size);
-
-    components::blueprint_variable_vector<encrypted_input_policy::field_type> eid_packed;
-    std::size_t eid_packed_size = (eid.size() + (chunk_size - 1)) / chunk_size;
-    eid_packed.allocate(bp, eid_packed_size);
-
-    components::blueprint_variable_vector<encrypted_input_policy::field_type> sn_packed;
-    std::size_t sn_packed_size = (encrypted_input_policy::hash_component::digest_bits + (chunk_size - 1)) / chunk_size;
-    sn_packed.allocate(bp, sn_packed_size);
-
-    components::blueprint_variable_vector<encrypted_input_policy::field_type> root_packed;
-    std::size_t root_packed_size = (encrypted_input_policy::hash_component::digest_bits + (chunk_size - 1)) / chunk_size;
-    root_packed.allocate(bp, root_packed_size);
-
-    std::size_t primary_input_size = bp.num_variables();
-
-    components::block_variable<encrypted_input_policy::field_type> eid_block(bp, eid.size());
-    components::digest_variable<encrypted_input_policy::field_type> sn_digest(
-            bp, encrypted_input_policy::hash_component::digest_bits);
-    components::digest_variable<encrypted_input_policy::field_type> root_digest(
-            bp, encrypted_input_policy::merkle_hash_component::digest_bits);
-    logln("Variables number in the generated R1CS: " , bp.num_variables() );
-
-    components::multipacking_component<encrypted_input_policy::field_type> eid_packer(bp, eid_block.bits, eid_packed, chunk_size);
-    components::multipacking_component<encrypted_input_policy::field_type> sn_packer(bp, sn_digest.bits, sn_packed, chunk_size);
-    components::multipacking_component<encrypted_input_policy::field_type> root_packer(bp, root_digest.bits, root_packed, chunk_size);
-    logln("Variables number in the generated R1CS: " , bp.num_variables() );
-
-    components::blueprint_variable_vector<encrypted_input_policy::field_type> address_bits_va;
-    address_bits_va.allocate(bp, tree_depth);
-    encrypted_input_policy::merkle_proof_component path_var(bp, tree_depth);
-    components::block_variable<encrypted_input_policy::field_type> sk_block(bp,
-                                                                            encrypted_input_policy::secret_key_bits);
-    logln("Variables number in the generated R1CS: " , bp.num_variables() );
-    encrypted_input_policy::voting_component vote_var(
-            bp, m_block, eid_block, sn_digest, root_digest, address_bits_va, path_var, sk_block,
-            components::blueprint_variable<encrypted_input_policy::field_type>(0));
-    logln("Variables number in the generated R1CS: " , bp.num_variables() );
-
-    eid_packer.generate_r1cs_constraints(true);
-    sn_packer.generate_r1cs_constraints(true);
-    root_packer.generate_r1cs_constraints(true);
-
-    path_var.generate_r1cs_constraints();
-    vote_var.generate_r1cs_constraints();
-    logln("R1CS generation finished." );
-    logln("Constraints number in the generated R1CS: " , bp.num_constraints() );
-    logln("Variables number in the generated R1CS: " , bp.num_variables() );
-    bp.set_input_sizes(primary_input_size);
-
-    // BOOST_ASSERT(!bp.is_satisfied());
-    path_var.generate_r1cs_witness(path, true);
-    BOOST_ASSERT(!bp.is_satisfied());
-    address_bits_va.fill_with_bits_of_ulong(bp, path_var.address);
-    BOOST_ASSERT(!bp.is_satisfied());
-    BOOST_ASSERT(address_bits_va.get_field_element_from_bits(bp) == path_var.address);
-    m_block.generate_r1cs_witness(m);
-    BOOST_ASSERT(!bp.is_satisfied());
-    eid_block.generate_r1cs_witness(eid);
-    BOOST_ASSERT(!bp.is_satisfied());
-    sk_block.generate_r1cs_witness(sk);
-    BOOST_ASSERT(!bp.is_satisfied());
-    vote_var.generate_r1cs_witness(tree.root(), sn);
-    BOOST_ASSERT(!bp.is_satisfied());
-    eid_packer.generate_r1cs_witness_from_bits();
-    BOOST_ASSERT(!bp.is_satisfied());
-    root_packer.generate_r1cs_witness_from_bits();
-    BOOST_ASSERT(!bp.is_satisfied());
-    sn_packer.generate_r1cs_witness_from_bits();
-    BOOST_ASSERT(bp.is_satisfied());
-
-    logln("Voter " , proof_idx , " generates its vote consisting of proof and cipher text..." );
-    random::algebraic_random_device<typename encrypted_input_policy::pairing_curve_type::scalar_field_type> d;
-    typename encrypted_input_policy::encryption_scheme_type::cipher_type cipher_text =
-            encrypt<encrypted_input_policy::encryption_scheme_type,
-    modes::verifiable_encryption<encrypted_input_policy::encryption_scheme_type>>(
-            m_field, {d(), pk_eid, gg_keypair, bp.primary_input(), bp.auxiliary_input()});
-    logln("Vote generated." );
-
-    logln("Rerandomization of the cipher text and proof started..." );
-    std::vector<typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type> rnd_rerandomization;
-    for (std::size_t i = 0; i < 3; ++i) {
-        rnd_rerandomization.emplace_back(d());
-    }
-    typename encrypted_input_policy::encryption_scheme_type::cipher_type rerand_cipher_text =
-            rerandomize<encrypted_input_policy::encryption_scheme_type>(rnd_rerandomization, cipher_text.first,
-                                                                        {pk_eid, gg_keypair, cipher_text.second});
-    logln("Rerandomization finished." );
-
-    logln("Voter " , proof_idx , " marshalling started..." );
-    std::size_t eid_offset = m.size();
-    std::size_t sn_offset = eid_offset + eid_packed.size();
-    std::size_t rt_offset = sn_offset + sn_packed.size();
-    std::size_t rt_offset_end = rt_offset + root_packed.size();
-    typename encrypted_input_policy::proof_system::primary_input_type pinput = bp.primary_input();
-    marshaling_policy::serialize_data(
-            proof_idx, rerand_cipher_text.second,
-            typename encrypted_input_policy::proof_system::primary_input_type {std::cbegin(pinput) + eid_offset,
-                                                                               std::cend(pinput)},
-            rerand_cipher_text.first,
-            typename encrypted_input_policy::proof_system::primary_input_type {std::cbegin(pinput) + sn_offset,
-                                                                               std::cbegin(pinput) + rt_offset},
-            proof_blob, pinput_blob, ct_blob, sn_blob);
-    logln("Marshalling finished." );
-#ifdef DEBUG_VERIFY_BALLOT
-    logln("Sender verifies rerandomized encrypted ballot and proof..." );
-    bool enc_verification_ans = verify_encryption<encrypted_input_policy::encryption_scheme_type>(
-        rerand_cipher_text.first,
-        {pk_eid, gg_keypair.second, rerand_cipher_text.second,
-         typename encrypted_input_policy::proof_system::primary_input_type {std::cbegin(pinput) + m.size(),
-                                                                        std::cend(pinput)}});
-    BOOST_ASSERT(enc_verification_ans);
-    logln("Encryption verification of rerandomazed cipher text and proof finished." );
-#else
-    logln("Skipping ballot verification");
-#endif
+    if (!affine.empty()) {
+        add_normalized(affine.front());
+    }
+    return rest;
+}
+
+// Deserializes the encrypted ballots and sums them up slot by slot. Ballots are split into contiguous chunks which are
+// summed in parallel, then the partial sums of the chunks are added up pairwise, level by level. Within a chunk,
+// ballots are deserialized batch_size at a time and every slot of the batch is summed by sum_points_batched.
+typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type
+aggregate_cts(const std::vector<std::vector<std::uint8_t>> &cts_blobs, std::size_t threads_number = 0) {
+    using ct_type = typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type;
+    using point_type = typename ct_type::value_type;
+    constexpr std::size_t batch_size = 256;
+    BOOST_ASSERT_MSG(!cts_blobs.empty(), "No encrypted ballots to aggregate!");
+
+    // A few chunks per thread, so that a slow chunk doesn't leave the other threads idle.
+    std::size_t chunks_number = std::min(cts_blobs.size(), 4 * resolve_threads_number(threads_number));
+    std::size_t chunk_size = (cts_blobs.size() + chunks_number - 1) / chunks_number;
+    chunks_number = (cts_blobs.size() + chunk_size - 1) / chunk_size;
+
+    std::vector<ct_type> partial_sums(chunks_number);
+    parallel_for(chunks_number, threads_number, [&](std::size_t chunk_idx) {
+        std::size_t begin = chunk_idx * chunk_size;
+        std::size_t end = std::min(begin + chunk_size, cts_blobs.size());
+        ct_type &ct_sum = partial_sums[chunk_idx];
+        std::vector<ct_type> batch;
+        std::vector<point_type> slot_points;
+        for (std::size_t batch_begin = begin; batch_begin < end; batch_begin += batch_size) {
+            std::size_t batch_end = std::min(batch_begin + batch_size, end);
+            batch.clear();
+            for (std::size_t proof_idx = batch_begin; proof_idx < batch_end; ++proof_idx) {
+                batch.emplace_back(marshaling_policy::deserialize_ct(cts_blobs[proof_idx]));
+                BOOST_ASSERT_MSG(std::size(batch.back()) == std::size(batch.front()), "Wrong size of the ct!");
+            }
+            if (ct_sum.empty()) {
+                ct_sum.assign(std::size(batch.front()), point_type::zero());
+            }
+            BOOST_ASSERT_MSG(std::size(ct_sum) == std::size(batch.front()), "Wrong size of the ct!");
+            for (std::size_t i = 0; i < std::size(ct_sum); ++i) {
+                slot_points.clear();
+                for (const auto &ct : batch) {
+                    slot_points.emplace_back(ct[i]);
+                }
+                ct_sum[i] = ct_sum[i] + sum_points_batched(slot_points);
+            }
+        }
+    });
+
+    for (std::size_t step = 1; step < chunks_number; step *= 2) {
+        parallel_for((chunks_number + 2 * step - 1) / (2 * step), threads_number, [&](std::size_t pair_idx) {
+            std::size_t left = pair_idx * 2 * step;
+            std::size_t right = left + step;
+            if (right >= chunks_number) {
+                return;
+            }
+            add_ct(partial_sums[left], partial_sums[right]);
+        });
+    }
+
+    return partial_sums[0];
 }
 
+// Running sum of the encrypted ballots. Ballots are added one at a time or in chunks as they are committed, and the
+// sum can be checkpointed to a blob and restored, so closing an election only takes the final decryption and memory
+// stays independent of the number of voters.
+class tally_accumulator {
+public:
+    using ct_type = typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type;
+
+    // Checkpoint layout: number of aggregated ballots as 8 big-endian octets followed by the marshalled ct sum.
+    static constexpr std::size_t ballots_number_octets = 8;
+
+    tally_accumulator() = default;
+
+    explicit tally_accumulator(const std::vector<std::uint8_t> &checkpoint_blob) {
+        BOOST_ASSERT_MSG(checkpoint_blob.size() >= ballots_number_octets, "Tally checkpoint is too short!");
+        for (std::size_t i = 0; i < ballots_number_octets; ++i) {
+            ballots = (ballots << 8) | checkpoint_blob[i];
+        }
+        if (ballots > 0) {
+            ct_agg = marshaling_policy::deserialize_ct(
+                std::vector<std::uint8_t>(checkpoint_blob.begin() + ballots_number_octets, checkpoint_blob.end()));
+        }
+    }
+
+    void add(const ct_type &ct, std::size_t ct_ballots_number = 1) {
+        if (ballots == 0) {
+            ct_agg = ct;
+        } else {
+            add_ct(ct_agg, ct);
+        }
+        ballots += ct_ballots_number;
+    }
+
+    void add(const std::vector<std::uint8_t> &ct_blob) {
+        add(marshaling_policy::deserialize_ct(ct_blob));
+    }
+
+    void add(const std::vector<std::vector<std::uint8_t>> &cts_blobs, std::size_t threads_number = 0) {
+        if (!cts_blobs.empty()) {
+            add(aggregate_cts(cts_blobs, threads_number), cts_blobs.size());
+        }
+    }
+
+    std::size_t ballots_number() const {
+        return ballots;
+    }
+
+    const ct_type &ct_sum() const {
+        BOOST_ASSERT_MSG(ballots > 0, "No encrypted ballots were aggregated!");
+        return ct_agg;
+    }
+
+    std::vector<std::uint8_t> checkpoint() const {
+        std::vector<std::uint8_t> blob(ballots_number_octets);
+        for (std::size_t i = 0; i < ballots_number_octets; ++i) {
+            blob[ballots_number_octets - 1 - i] = static_cast<std::uint8_t>(ballots >> (8 * i));
+        }
+        if (ballots > 0) {
+            auto ct_blob = marshaling_policy::serialize_ct(ct_agg);
+            blob.insert(blob.end(), ct_blob.begin(), ct_blob.end());
+        }
+        return blob;
+    }
+
+private:
+    ct_type ct_agg;
+    std::size_t ballots = 0;
+};
+
 void process_encrypted_input_mode_tally_admin_phase(
         std::size_t tree_depth,
-        const std::vector<std::vector<std::uint8_t>> &cts_blobs,
-        const std::vector<std::uint8_t> &sk_eid_blob,
-        const std::vector<std::uint8_t> &vk_eid_blob,
-        const std::vector<std::uint8_t> &pk_crs_blob,
-        const std::vector<std::uint8_t> &vk_crs_blob,
+        const tally_accumulator &accumulator,
+        blob_view sk_eid_blob,
+        blob_view vk_eid_blob,
+        blob_view pk_crs_blob,
+        blob_view vk_crs_blob,
         std::vector<std::uint8_t> &dec_proof_blob,
         std::vector<std::uint8_t> &voting_res_blob) {
 
@@ -1166,39 +2619,18 @@ void process_encrypted_input_mode_tally_admin_phase(
 
     auto sk_eid = marshaling_policy::deserialize_sk_eid(sk_eid_blob);
     auto vk_eid = marshaling_policy::deserialize_vk_eid(vk_eid_blob);
-    typename encrypted_input_policy::proof_system::keypair_type gg_keypair = {
-            marshaling_policy::deserialize_pk_crs(pk_crs_blob), marshaling_policy::deserialize_vk_crs(vk_crs_blob)};
-    logln("tally votes begin cts deserialization" );
-
-    std::size_t participants_number = 1 << tree_depth;
-    BOOST_ASSERT(cts_blobs.size() <= participants_number);
-    std::vector<typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type> cts;
-    cts.reserve(cts_blobs.size());
-    for (auto proof_idx = 0; proof_idx < cts_blobs.size(); proof_idx++) {
-    cts.push_back(marshaling_policy::deserialize_ct(cts_blobs[proof_idx]));
-    }
-
+    auto crs = crs_cache::acquire(pk_crs_blob, vk_crs_blob);
+    const crs_cache::keypair_type &gg_keypair = *crs;
     logln("tally votes finished deserialization" );
 
-    logln("Administrator processes tally phase - aggregates encrypted ballots, decrypts aggregated ballot, "
-          "generate decryption proof...", "\n");
-
-    auto ct_agg = cts[0];
-    logln("Administrator counts final results..." );
-    for (auto proof_idx = 1; proof_idx < cts.size(); proof_idx++) {
-        auto ct_i = cts[proof_idx];
-        BOOST_ASSERT_MSG(std::size(ct_agg) == std::size(ct_i), "Wrong size of the ct!");
-        for (std::size_t i = 0; i < std::size(ct_i); ++i) {
-            ct_agg[i] = ct_agg[i] + ct_i[i];
-        }
-    }
-    logln("Final results are ready." );
+    std::size_t participants_number = 1 << tree_depth;
+    BOOST_ASSERT(accumulator.ballots_number() <= participants_number);
 
     logln("Final results decryption..." );
     typename encrypted_input_policy::encryption_scheme_type::decipher_type decipher_rerand_sum_text =
             decrypt<encrypted_input_policy::encryption_scheme_type,
     modes::verifiable_encryption<encrypted_input_policy::encryption_scheme_type>>(
-            ct_agg, {sk_eid, vk_eid, gg_keypair});
+            accumulator.ct_sum(), {sk_eid, vk_eid, gg_keypair});
     logln("Decryption finished." );
     BOOST_ASSERT_MSG(decipher_rerand_sum_text.first.size() == encrypted_input_policy::msg_size,
                      "Deciphered lens not equal");
@@ -1214,50 +2646,52 @@ void process_encrypted_input_mode_tally_admin_phase(
     logln("Marshalling finished." );
 }
 
-bool process_encrypted_input_mode_tally_voter_phase(
+void process_encrypted_input_mode_tally_admin_phase(
         std::size_t tree_depth,
         const std::vector<std::vector<std::uint8_t>> &cts_blobs,
-        const std::vector<std::uint8_t> &vk_eid_blob,
-        const std::vector<std::uint8_t> &pk_crs_blob,
-        const std::vector<std::uint8_t> &vk_crs_blob,
-        const std::vector<std::uint8_t> &voting_res_blob,
-        const std::vector<std::uint8_t> &dec_proof_blob) {
+        blob_view sk_eid_blob,
+        blob_view vk_eid_blob,
+        blob_view pk_crs_blob,
+        blob_view vk_crs_blob,
+        std::vector<std::uint8_t> &dec_proof_blob,
+        std::vector<std::uint8_t> &voting_res_blob) {
+    logln("Administrator processes tally phase - aggregates encrypted ballots, decrypts aggregated ballot, "
+          "generate decryption proof...", "\n");
+
+    logln("Administrator counts final results..." );
+    tally_accumulator accumulator;
+    accumulator.add(cts_blobs);
+    logln("Final results are ready." );
+
+    process_encrypted_input_mode_tally_admin_phase(tree_depth, accumulator, sk_eid_blob, vk_eid_blob, pk_crs_blob,
+                                                   vk_crs_blob, dec_proof_blob, voting_res_blob);
+}
+
+bool process_encrypted_input_mode_tally_voter_phase(
+        std::size_t tree_depth,
+        const tally_accumulator &accumulator,
+        blob_view vk_eid_blob,
+        blob_view pk_crs_blob,
+        blob_view vk_crs_blob,
+        blob_view voting_res_blob,
+        blob_view dec_proof_blob) {
     
     logln("verify tally begin deserialization" );
 
     auto vk_eid = marshaling_policy::deserialize_vk_eid(vk_eid_blob);
-    typename encrypted_input_policy::proof_system::keypair_type gg_keypair = {
-            marshaling_policy::deserialize_pk_crs(pk_crs_blob), marshaling_policy::deserialize_vk_crs(vk_crs_blob)};
+    auto crs = crs_cache::acquire(pk_crs_blob, vk_crs_blob);
+    const crs_cache::keypair_type &gg_keypair = *crs;
 
     auto voting_result = marshaling_policy::deserialize_scalar_vector(voting_res_blob);
     auto dec_proof = marshaling_policy::deserialize_decryption_proof(dec_proof_blob);
 
-    logln("verify tally begin cts deserialization" );
-    std::size_t participants_number = 1 << tree_depth;
-    BOOST_ASSERT(cts_blobs.size() <= participants_number);
-    std::vector<typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type> cts;
-    cts.reserve(cts_blobs.size());
-    for (auto proof_idx = 0; proof_idx < cts_blobs.size(); proof_idx++) {
-    cts.push_back(marshaling_policy::deserialize_ct(cts_blobs[proof_idx]));
-    }
-
     logln("verify tally finished deserialization" );
-    
-    logln("Voter processes tally phase - aggregates encrypted ballots, verifies voting result using decryption "
-          "proof...", "\n");
-
-    auto ct_agg = cts[0];
-    for (auto proof_idx = 1; proof_idx < cts.size(); proof_idx++) {
-        auto ct_i = cts[proof_idx];
-        BOOST_ASSERT_MSG(std::size(ct_agg) == std::size(ct_i), "Wrong size of the ct!");
-        for (std::size_t i = 0; i < std::size(ct_i); ++i) {
-            ct_agg[i] = ct_agg[i] + ct_i[i];
-        }
-    }
+    std::size_t participants_number = 1 << tree_depth;
+    BOOST_ASSERT(accumulator.ballots_number() <= participants_number);
 
     logln("Verification of the deciphered tally result." );
     bool dec_verification_ans = verify_decryption<encrypted_input_policy::encryption_scheme_type>(
-            ct_agg, voting_result, {vk_eid, gg_keypair, dec_proof});
+            accumulator.ct_sum(), voting_result, {vk_eid, gg_keypair, dec_proof});
     BOOST_ASSERT_MSG(dec_verification_ans, "Decryption proof verification failed.");
     logln("Decryption proof verification succeeded." );
     logln("Results of voting:" );
@@ -1267,4 +2701,23 @@ bool process_encrypted_input_mode_tally_voter_phase(
     logln();
 
     return dec_verification_ans;
-}
\ No newline at end of file
+}
+
+bool process_encrypted_input_mode_tally_voter_phase(
+        std::size_t tree_depth,
+        const std::vector<std::vector<std::uint8_t>> &cts_blobs,
+        blob_view vk_eid_blob,
+        blob_view pk_crs_blob,
+        blob_view vk_crs_blob,
+        blob_view voting_res_blob,
+        blob_view dec_proof_blob) {
+    logln("Voter processes tally phase - aggregates encrypted ballots, verifies voting result using decryption "
+          "proof...", "\n");
+
+    tally_accumulator accumulator;
+    accumulator.add(cts_blobs);
+    logln("verify tally finished cts deserialization and aggregation" );
+
+    return process_encrypted_input_mode_tally_voter_phase(tree_depth, accumulator, vk_eid_blob, pk_crs_blob,
+                                                          vk_crs_blob, voting_res_blob, dec_proof_blob);
+}
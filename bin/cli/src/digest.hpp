@@ -0,0 +1,102 @@
+//---------------------------------------------------------------------------//
+// Copyright (c) 2022 Noam Y <@NoamDev>
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//---------------------------------------------------------------------------//
+
+#ifndef DEVOTE_DIGEST_HPP
+#define DEVOTE_DIGEST_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+#include <boost/assert.hpp>
+
+// Fixed-size bit string (voter key, Pedersen digest, Merkle tree node) packed eight bits per octet, most significant
+// bit first, which is also its blob layout. It is converted to bits only where crypto3 takes bit ranges.
+template<std::size_t Bits>
+class digest {
+public:
+    constexpr static std::size_t bits = Bits;
+    constexpr static std::size_t octets = Bits / 8 + (Bits % 8 ? 1 : 0);
+
+    digest() : packed {} {
+    }
+
+    // Packs the first Bits bits of the range, which is at least that long.
+    template<typename BitRange>
+    static digest from_bits(const BitRange &bit_range) {
+        digest result;
+        std::size_t i = 0;
+        for (auto it = std::begin(bit_range); i < Bits; ++it, ++i) {
+            BOOST_ASSERT(it != std::end(bit_range));
+            result.set(i, *it);
+        }
+        return result;
+    }
+
+    static digest from_octets(const std::uint8_t *data) {
+        digest result;
+        std::copy(data, data + octets, result.packed.begin());
+        return result;
+    }
+
+    bool operator[](std::size_t i) const {
+        return (packed[i / 8] >> (7 - i % 8)) & 1;
+    }
+
+    void set(std::size_t i, bool bit) {
+        std::uint8_t mask = std::uint8_t(1 << (7 - i % 8));
+        packed[i / 8] = bit ? std::uint8_t(packed[i / 8] | mask) : std::uint8_t(packed[i / 8] & ~mask);
+    }
+
+    // Appends the bits to out, e.g. to build the input of a hash.
+    template<typename BitContainer>
+    void append_bits(BitContainer &out) const {
+        for (std::size_t i = 0; i < Bits; ++i) {
+            out.push_back((*this)[i]);
+        }
+    }
+
+    std::vector<bool> to_bits() const {
+        std::vector<bool> result;
+        result.reserve(Bits);
+        append_bits(result);
+        return result;
+    }
+
+    const std::uint8_t *data() const {
+        return packed.data();
+    }
+
+    std::vector<std::uint8_t> blob() const {
+        return {packed.begin(), packed.end()};
+    }
+
+    bool operator==(const digest &other) const {
+        return packed == other.packed;
+    }
+
+    bool operator!=(const digest &other) const {
+        return packed != other.packed;
+    }
+
+private:
+    std::array<std::uint8_t, octets> packed;
+};
+
+#endif    // DEVOTE_DIGEST_HPP
@@ -40,7 +40,8 @@ extern "C" {
      NSMutableData * const proof_out,
      NSMutableData * const pinput_out,
      NSMutableData * const ct_out,
-     NSMutableData * const sn_out) {
+     NSMutableData * const sn_out,
+     size_t check_level) {
     
      std::vector<std::uint8_t> merkle_tree_vector = readNSData_to_vector(merkle_tree);
      std::vector<std::uint8_t> rt_vector = readNSData_to_vector(rt);
@@ -59,7 +60,49 @@ extern "C" {
 
      process_encrypted_input_mode_vote_phase(tree_depth, eid_bits, voter_idx, vote, merkle_tree_vector, rt_vector,
                                              eid_vector, sk_vector, pk_eid_vector, proving_key_vector, verification_key_vector,
-                                             proof_out_vector, pinput_out_vector, ct_out_vector, sn_out_vector);
+                                             proof_out_vector, pinput_out_vector, ct_out_vector, sn_out_vector,
+                                             static_cast<witness_check_level>(check_level));
+
+     write_vector_to_NSData(proof_out_vector, proof_out);
+     write_vector_to_NSData(pinput_out_vector, pinput_out);
+     write_vector_to_NSData(ct_out_vector, ct_out);
+     write_vector_to_NSData(sn_out_vector, sn_out);
+ }
+
+ void devote_generate_vote_from_copath(
+     size_t tree_depth, size_t voter_idx, size_t vote,
+     const NSData * const copath,
+     const NSData * const rt,
+     const NSData * const eid,
+     const NSData * const sk,
+     const NSData * const pk_eid,
+     const NSData * const proving_key,
+     const NSData * const verification_key,
+     NSMutableData * const proof_out,
+     NSMutableData * const pinput_out,
+     NSMutableData * const ct_out,
+     NSMutableData * const sn_out,
+     size_t check_level) {
+
+     std::vector<std::uint8_t> copath_vector = readNSData_to_vector(copath);
+     std::vector<std::uint8_t> rt_vector = readNSData_to_vector(rt);
+     std::vector<std::uint8_t> eid_vector = readNSData_to_vector(eid);
+     std::vector<std::uint8_t> sk_vector = readNSData_to_vector(sk);
+     std::vector<std::uint8_t> pk_eid_vector = readNSData_to_vector(pk_eid);
+     std::vector<std::uint8_t> proving_key_vector = readNSData_to_vector(proving_key);
+     std::vector<std::uint8_t> verification_key_vector = readNSData_to_vector(verification_key);
+
+     std::vector<std::uint8_t> proof_out_vector;
+     std::vector<std::uint8_t> pinput_out_vector;
+     std::vector<std::uint8_t> ct_out_vector;
+     std::vector<std::uint8_t> sn_out_vector;
+
+     const std::size_t eid_bits = 64;
+
+     process_encrypted_input_mode_vote_phase_copath(tree_depth, eid_bits, voter_idx, vote, copath_vector, rt_vector,
+                                                    eid_vector, sk_vector, pk_eid_vector, proving_key_vector, verification_key_vector,
+                                                    proof_out_vector, pinput_out_vector, ct_out_vector, sn_out_vector,
+                                                    static_cast<witness_check_level>(check_level));
 
      write_vector_to_NSData(proof_out_vector, proof_out);
      write_vector_to_NSData(pinput_out_vector, pinput_out);
@@ -19,6 +19,10 @@
 #include "common.hpp"
 #include <filesystem>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 namespace boost {
     void assertion_failed(char const *expr, char const *function, char const *file, long line) {
         std::cerr << "Error: in file " << file << ": in function " << function << ": on line " << line << std::endl;
@@ -377,17 +381,283 @@ static std::vector<std::uint8_t> read_obj(const Path &path) {
     BOOST_ASSERT_MSG(
             std::filesystem::exists(path),
             (std::string("File ") + path + std::string(" doesn't exist, make sure you created it!")).c_str());
+    std::vector<std::uint8_t> blob(std::filesystem::file_size(path));
     std::ifstream in(path, std::ios_base::binary);
-    std::stringstream buffer;
-    buffer << in.rdbuf();
-    auto blob_str = buffer.str();
-    return {std::cbegin(blob_str), std::cend(blob_str)};
+    in.read(reinterpret_cast<char *>(blob.data()), blob.size());
+    return blob;
+}
+
+// Read-only memory mapping of a file. Large artifacts, the proving key first of all, are deserialized right from the
+// mapping through blob_view instead of being read into memory first.
+class mapped_file {
+public:
+    explicit mapped_file(const std::string &path) {
+        BOOST_ASSERT_MSG(
+                std::filesystem::exists(path),
+                (std::string("File ") + path + std::string(" doesn't exist, make sure you created it!")).c_str());
+        size = std::filesystem::file_size(path);
+        if (size == 0) {
+            return;
+        }
+        int fd = ::open(path.c_str(), O_RDONLY);
+        BOOST_ASSERT_MSG(fd >= 0, (std::string("File ") + path + std::string(" can't be opened!")).c_str());
+        void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        BOOST_ASSERT_MSG(addr != MAP_FAILED, (std::string("File ") + path + std::string(" can't be mapped!")).c_str());
+        ::madvise(addr, size, MADV_SEQUENTIAL);
+        data = static_cast<const std::uint8_t *>(addr);
+    }
+
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    ~mapped_file() {
+        if (data != nullptr) {
+            ::munmap(const_cast<std::uint8_t *>(data), size);
+        }
+    }
+
+    blob_view blob() const {
+        return {data, size};
+    }
+
+    operator blob_view() const {
+        return blob();
+    }
+
+private:
+    const std::uint8_t *data = nullptr;
+    std::size_t size = 0;
+};
+
+// serialize_bitarray and deserialize_bitarray should read and write the blobs detail::pack with big_octet_big_bit
+// did.
+template<std::size_t Bits>
+void test_bitarray_packing() {
+    constexpr std::size_t octets = Bits / 8 + (Bits % 8 ? 1 : 0);
+    auto random_bits = generate_random_digest<Bits>().to_bits();
+    std::array<bool, Bits> bitarray;
+    std::copy(random_bits.begin(), random_bits.end(), bitarray.begin());
+
+    std::array<std::uint8_t, octets * 8> unpacked {};
+    std::copy_n(bitarray.begin(), Bits, unpacked.begin());
+    std::array<std::uint8_t, octets> packed {};
+    nil::crypto3::detail::pack<nil::crypto3::stream_endian::big_octet_big_bit,
+                               nil::crypto3::stream_endian::big_octet_big_bit, 1, 8>(unpacked.begin(), unpacked.end(),
+                                                                                     packed.begin());
+
+    auto blob = marshaling_policy::serialize_bitarray<Bits>(bitarray);
+    BOOST_ASSERT_MSG(std::equal(blob.begin(), blob.end(), packed.begin(), packed.end()),
+                     "Bit array blob differs from the one detail::pack makes!");
+    BOOST_ASSERT_MSG(marshaling_policy::deserialize_bitarray<Bits>(blob) == bitarray,
+                     "Bit array doesn't survive serialization!");
+}
+
+// get_field_element_from_bits should give the element the former loop did, one doubling and one field addition per
+// bit from the most significant one down.
+void test_field_element_from_bits() {
+    using scalar_field_value_type = typename encrypted_input_policy::pairing_curve_type::scalar_field_type::value_type;
+    constexpr std::size_t max_bits = encrypted_input_policy::field_type::value_bits - 1;
+
+    auto random_bits = generate_random_digest<max_bits>().to_bits();
+    for (std::size_t bits_number : {std::size_t(0), std::size_t(1), std::size_t(63), std::size_t(64), std::size_t(65),
+                                    std::size_t(128), max_bits}) {
+        std::vector<bool> bits(random_bits.begin(), random_bits.begin() + bits_number);
+        scalar_field_value_type expected = scalar_field_value_type::zero();
+        for (std::size_t i = 0; i < bits.size(); ++i) {
+            const scalar_field_value_type v = (bits[bits.size() - 1 - i] ? scalar_field_value_type::one() :
+                                                                           scalar_field_value_type::zero());
+            expected = expected + (expected + v);
+        }
+        BOOST_ASSERT_MSG(marshaling_policy::get_field_element_from_bits(bits) == expected,
+                         "Field element differs from the one built bit by bit!");
+    }
+}
+
+// aggregate_cts should give the sum of the plain projective additions, including the pairs its batched affine
+// additions can't take: equal points, opposite points and points at infinity.
+void test_aggregate_cts() {
+    using ct_type = typename encrypted_input_policy::encryption_scheme_type::cipher_type::first_type;
+    using point_type = typename ct_type::value_type;
+    constexpr std::size_t ct_size = encrypted_input_policy::msg_size + 2;
+    // More than 4 chunks of 256 ballots, so a single-threaded chunk spans several batches.
+    constexpr std::size_t ballots_number = 1100;
+
+    std::vector<std::vector<std::uint8_t>> cts_blobs;
+    ct_type expected(ct_size, point_type::zero());
+    point_type multiple = point_type::zero();
+    for (std::size_t ballot_idx = 0; ballot_idx < ballots_number; ++ballot_idx) {
+        ct_type ct;
+        for (std::size_t i = 0; i < ct_size; ++i) {
+            multiple = multiple + point_type::one();
+            // Ballots 2 and 3 of every 8 are equal, 4 and 5 opposite, 6 is at infinity.
+            point_type point = multiple;
+            if (ballot_idx % 8 >= 2 && ballot_idx % 8 <= 4) {
+                point = point_type::one();
+            } else if (ballot_idx % 8 == 5) {
+                point = -point_type::one();
+            } else if (ballot_idx % 8 == 6) {
+                point = point_type::zero();
+            }
+            ct.emplace_back(point);
+            expected[i] = expected[i] + point;
+        }
+        cts_blobs.emplace_back(marshaling_policy::serialize_ct(ct));
+    }
+
+    for (std::size_t threads_number : {std::size_t(1), std::size_t(3)}) {
+        ct_type ct_sum = aggregate_cts(cts_blobs, threads_number);
+        BOOST_ASSERT_MSG(ct_sum.size() == ct_size, "Wrong size of the ct sum!");
+        for (std::size_t i = 0; i < ct_size; ++i) {
+            BOOST_ASSERT_MSG(ct_sum[i] == expected[i], "Batched ct sum differs from the plain one!");
+        }
+    }
+    logln("Batched ct sum matches the plain one." );
+}
+
+// Merkle tree of the public keys padded with all-zero keys, as containers::make_merkle_tree builds it.
+containers::merkle_tree<encrypted_input_policy::merkle_hash_type, encrypted_input_policy::arity>
+make_reference_merkle_tree(std::size_t tree_depth, const std::vector<std::vector<std::uint8_t>> &pks) {
+    std::vector<std::array<bool, encrypted_input_policy::public_key_bits>> public_keys(
+            std::size_t(1) << tree_depth, std::array<bool, encrypted_input_policy::public_key_bits> {});
+    for (std::size_t i = 0; i < pks.size(); ++i) {
+        public_keys[i] = marshaling_policy::deserialize_bitarray<encrypted_input_policy::public_key_bits>(pks[i]);
+    }
+    return containers::make_merkle_tree<encrypted_input_policy::merkle_hash_type, encrypted_input_policy::arity>(
+            std::cbegin(public_keys), std::cend(public_keys));
+}
+
+// Dense Merkle tree blob serialized node by node with serialize_bitarray.
+template<typename MerkleTree>
+std::vector<std::uint8_t> serialize_reference_merkle_tree(const MerkleTree &tree) {
+    constexpr std::size_t digest_bits = encrypted_input_policy::merkle_hash_type::digest_bits;
+    std::vector<std::uint8_t> blob;
+    for (auto it = tree.cbegin(); it != tree.cend(); ++it) {
+        std::array<bool, digest_bits> node;
+        std::copy_n(std::begin(*it), digest_bits, node.begin());
+        auto node_blob = marshaling_policy::serialize_bitarray<digest_bits>(node);
+        blob.insert(blob.end(), node_blob.begin(), node_blob.end());
+    }
+    return blob;
+}
+
+// Co-path cut from the Merkle tree blob should give the proof merkle_proof_type(tree, leaf) gives for the tree
+// containers::make_merkle_tree builds.
+void test_merkle_copath(std::size_t tree_depth, const std::vector<std::vector<std::uint8_t>> &pks) {
+    auto tree = make_reference_merkle_tree(tree_depth, pks);
+    auto merkle_tree_blob = serialize_reference_merkle_tree(tree);
+    std::vector<bool> root(std::begin(tree.root()), std::end(tree.root()));
+    for (std::size_t voter_idx = 0; voter_idx < (std::size_t(1) << tree_depth); ++voter_idx) {
+        merkle_copath copath(tree_depth, voter_idx, extract_copath(tree_depth, merkle_tree_blob, voter_idx));
+        std::vector<bool> leaf(std::begin(tree[voter_idx]), std::end(tree[voter_idx]));
+        BOOST_ASSERT_MSG(copath.leaf() == leaf && copath.root() == root,
+                         "Merkle co-path leaf or root differs from the tree!");
+        BOOST_ASSERT_MSG(copath.proof() == merkle_copath::merkle_proof_type(tree, voter_idx),
+                         "Merkle co-path differs from the proof of the tree!");
+    }
+    logln("Merkle co-paths of " , pks.size() , " voters match the proofs of the tree." );
+}
+
+// make_merkle_tree_blob should build the tree and root containers::make_merkle_tree does, serialized as before.
+void test_merkle_tree_blob(std::size_t tree_depth, const std::vector<std::vector<std::uint8_t>> &pks) {
+    auto tree = make_reference_merkle_tree(tree_depth, pks);
+    std::vector<bool> reference_root(std::begin(tree.root()), std::end(tree.root()));
+    for (std::size_t threads_number : {std::size_t(1), std::size_t(0)}) {
+        encrypted_input_policy::merkle_node_type root;
+        auto merkle_tree_blob = make_merkle_tree_blob(
+                tree_depth, marshaling_policy::deserialize_voters_public_keys(tree_depth, pks), root, threads_number);
+        BOOST_ASSERT_MSG(merkle_tree_blob == serialize_reference_merkle_tree(tree),
+                         "Merkle tree blob differs from the tree containers::make_merkle_tree builds!");
+        BOOST_ASSERT_MSG(root.to_bits() == reference_root,
+                         "Merkle tree root differs from the one containers::make_merkle_tree gives!");
+    }
+    logln("Merkle tree of " , pks.size() , " voters matches containers::make_merkle_tree." );
+}
+
+// Sparse tree of the first voters_number public keys should have the root and the co-paths of the dense tree built
+// upon the same keys padded with empty leaves.
+void test_sparse_merkle_tree(std::size_t tree_depth, const std::vector<std::vector<std::uint8_t>> &pks,
+                             std::size_t voters_number) {
+    std::vector<std::vector<std::uint8_t>> voters_pks(pks.begin(), pks.begin() + voters_number);
+    std::vector<encrypted_input_policy::public_key_type> sparse_public_keys;
+    for (const auto &pk : voters_pks) {
+        sparse_public_keys.emplace_back(
+                marshaling_policy::deserialize_digest<encrypted_input_policy::public_key_bits>(pk));
+    }
+
+    encrypted_input_policy::merkle_node_type dense_root;
+    encrypted_input_policy::merkle_node_type sparse_root;
+    auto dense_blob = make_merkle_tree_blob(
+            tree_depth, marshaling_policy::deserialize_voters_public_keys(tree_depth, voters_pks), dense_root);
+    auto sparse_blob = make_merkle_tree_blob(tree_depth, sparse_public_keys, sparse_root, 0,
+                                             merkle_tree_format::sparse);
+    BOOST_ASSERT_MSG(sparse_root == dense_root, "Sparse Merkle tree root differs from the dense one!");
+    BOOST_ASSERT_MSG(voters_number == (std::size_t(1) << tree_depth) || sparse_blob.size() < dense_blob.size(),
+                     "Sparse Merkle tree blob isn't smaller than the dense one!");
+
+    merkle_tree_view sparse_tree(tree_depth, sparse_blob);
+    BOOST_ASSERT_MSG(sparse_tree.is_sparse() && sparse_tree.stored_leaves() == voters_number,
+                     "Sparse Merkle tree blob isn't recognized!");
+    for (std::size_t voter_idx = 0; voter_idx < (std::size_t(1) << tree_depth); ++voter_idx) {
+        BOOST_ASSERT_MSG(extract_copath(tree_depth, sparse_blob, voter_idx) ==
+                         extract_copath(tree_depth, dense_blob, voter_idx),
+                         "Sparse Merkle tree co-path differs from the dense one!");
+    }
+    logln("Sparse Merkle tree of " , voters_number , " voters matches the dense one." );
+}
+
+// Registering voters one by one into an empty sparse tree, and replaying the deltas on a replica, should give the
+// tree built in one pass upon the registered voters. The registered tree stores up to twice as many leaves, the extra
+// ones empty, so the trees are compared node by node rather than blob to blob.
+void test_merkle_tree_registration(std::size_t tree_depth, const std::vector<std::vector<std::uint8_t>> &pks,
+                                   std::size_t voters_number) {
+    encrypted_input_policy::merkle_node_type root;
+    std::vector<std::uint8_t> merkle_tree_blob =
+            make_merkle_tree_blob(tree_depth, {}, root, 0, merkle_tree_format::sparse);
+    std::vector<std::uint8_t> replica_blob = merkle_tree_blob;
+    std::vector<encrypted_input_policy::public_key_type> public_keys;
+    for (std::size_t voter_idx = 0; voter_idx < voters_number; ++voter_idx) {
+        std::vector<std::uint8_t> rt_blob;
+        std::vector<std::uint8_t> replica_rt_blob;
+        std::vector<std::uint8_t> delta_blob;
+        update_merkle_tree_leaf(tree_depth, merkle_tree_blob, voter_idx, pks[voter_idx], rt_blob, delta_blob);
+        apply_merkle_tree_delta(tree_depth, replica_blob, delta_blob, replica_rt_blob);
+
+        public_keys.emplace_back(
+                marshaling_policy::deserialize_digest<encrypted_input_policy::public_key_bits>(pks[voter_idx]));
+        merkle_tree_view one_pass_tree(
+                tree_depth, make_merkle_tree_blob(tree_depth, public_keys, root, 0, merkle_tree_format::sparse));
+        std::vector<std::uint8_t> one_pass_rt_blob = marshaling_policy::serialize_scalar_vector(
+                marshaling_policy::get_multi_field_element_from_bits(root.to_bits()));
+
+        merkle_tree_view registered_tree(tree_depth, merkle_tree_blob);
+        BOOST_ASSERT_MSG(registered_tree.stored_leaves() > voter_idx &&
+                         registered_tree.stored_leaves() <= std::max<std::size_t>(2 * voter_idx, 1),
+                         "Merkle tree of the registered voters didn't grow geometrically!");
+        for (std::size_t level = 0; level <= tree_depth; ++level) {
+            for (std::size_t idx = 0; idx < (registered_tree.leaves() >> level); ++idx) {
+                BOOST_ASSERT_MSG(registered_tree.node_digest(level, idx) == one_pass_tree.node_digest(level, idx),
+                                 "Merkle tree of the registered voters differs from the one built in one pass!");
+            }
+        }
+        BOOST_ASSERT_MSG(rt_blob == one_pass_rt_blob, "rt of the registered voters differs from the one built in one pass!");
+        BOOST_ASSERT_MSG(replica_blob == merkle_tree_blob && replica_rt_blob == rt_blob,
+                         "Merkle tree replica differs after applying the delta!");
+    }
+    logln("Merkle tree of " , voters_number , " voters registered one by one matches the one built in one pass." );
 }
 
 void test() {
     std::size_t tree_depth = 5;
     std::size_t eid_bits = 64;
 
+    test_bitarray_packing<1>();
+    test_bitarray_packing<encrypted_input_policy::secret_key_bits>();
+    test_bitarray_packing<256>();
+    test_field_element_from_bits();
+    logln("Bit packing matches the former implementation." );
+    test_aggregate_cts();
+
     std::size_t num_participants = 1 << tree_depth;
     std::vector<std::vector<std::uint8_t>> pks(num_participants);
     std::vector<std::vector<std::uint8_t>> sks(num_participants);
@@ -396,6 +666,15 @@ void test() {
         process_encrypted_input_mode_init_voter_phase(i, pks[i], sks[i]);
     }
 
+    test_merkle_copath(tree_depth, std::vector<std::vector<std::uint8_t>>(pks.begin(), pks.begin() + 5));
+    test_merkle_copath(tree_depth, pks);
+    test_merkle_tree_blob(tree_depth, std::vector<std::vector<std::uint8_t>>(pks.begin(), pks.begin() + 5));
+    test_merkle_tree_blob(tree_depth, pks);
+    for (std::size_t voters_number : {std::size_t(0), std::size_t(1), std::size_t(5), num_participants}) {
+        test_sparse_merkle_tree(tree_depth, pks, voters_number);
+    }
+    test_merkle_tree_registration(tree_depth, pks, 11);
+
     std::vector<std::uint8_t> r1cs_proving_key_out;
     std::vector<std::uint8_t> r1cs_verification_key_out;
 
@@ -430,18 +709,24 @@ void test() {
     process_encrypted_input_mode_vote_phase(
             tree_depth, eid_bits, voter_idx, vote, merkle_tree_output,
             rt_output,
-            eid_output, secret_key_output,
+            eid_output, sks[voter_idx],
             public_key_output,
             r1cs_proving_key_out,
-            verification_key_output,
+            r1cs_verification_key_out,
             proof_blob, pinput_blob, ct_blob,
             sn_blob);
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
     std::cout << "Vote Phase Time_execution: " << duration.count() << "ms" << std::endl;
 
+    auto verdicts = process_encrypted_input_mode_vote_verify_phase({proof_blob}, {pinput_blob}, {ct_blob}, eid_output,
+                                                                   rt_output, public_key_output,
+                                                                   r1cs_verification_key_out);
+    BOOST_ASSERT_MSG(verdicts.size() == 1 && verdicts[0], "Honestly cast ballot failed verification!");
+    logln("Ballot cast by voter " , voter_idx , " verified." );
+
 }
 
-void generate_test_data(std::size_t tree_depth) {
+void generate_test_data(std::size_t tree_depth, merkle_tree_format format) {
     logln("Generating test data for tree depth = ", tree_depth);
     const std::size_t eid_bits = 64;
     std::vector<std::uint8_t> r1cs_proving_key_blob;
@@ -479,7 +764,7 @@ void generate_test_data(std::size_t tree_depth) {
     process_encrypted_input_mode_init_admin_phase_generate_data(
             tree_depth, eid_bits, {voter_public_key_blob},
             eid_blob,
-            rt_blob, merkle_tree_blob);
+            rt_blob, merkle_tree_blob, 0, format);
     write_obj("eid.bin", {eid_blob});
     write_obj("rt.bin", {rt_blob});
     write_obj("merkle_tree.bin", {merkle_tree_blob});
@@ -488,14 +773,14 @@ void generate_test_data(std::size_t tree_depth) {
     logln("Finished generating test data");
 }
 
-void benchmark_vote_pahse(std::size_t tree_depth) {
+void benchmark_vote_pahse(std::size_t tree_depth, std::size_t ballots, std::size_t workers, std::size_t prover_threads) {
     logln("Reading data");
-    auto proving_key = read_obj("r1cs_proving_key.bin");
-    auto verification_key = read_obj("r1cs_verification_key.bin");
-    auto public_key = read_obj("public_key.bin");
+    mapped_file proving_key("r1cs_proving_key.bin");
+    mapped_file verification_key("r1cs_verification_key.bin");
+    mapped_file public_key("public_key.bin");
     auto voter_secret_key = read_obj("voter_secret_key.bin");
-    auto eid = read_obj("eid.bin");
-    auto rt = read_obj("rt.bin");
+    mapped_file eid("eid.bin");
+    mapped_file rt("rt.bin");
     auto merkle_tree = read_obj("merkle_tree.bin");
     logln("Running vote phase");
 
@@ -510,33 +795,122 @@ void benchmark_vote_pahse(std::size_t tree_depth) {
 
     auto start = std::chrono::high_resolution_clock::now();
 
-    process_encrypted_input_mode_vote_phase(
-            tree_depth, eid_bits, voter_idx, vote, merkle_tree,
-            rt,
-            eid, voter_secret_key,
-            public_key,
-            proving_key,
-            verification_key,
-            proof_blob, pinput_blob, ct_blob,
-            sn_blob);
+    prover_session session(tree_depth, eid_bits, merkle_tree, rt, eid, public_key, proving_key, verification_key);
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
-    std::cout << "Vote Phase Time_execution: " << duration.count() << "ms" << std::endl;
+    std::cout << "Prover Session Setup Time_execution: " << duration.count() << "ms" << std::endl;
+
+    if (workers > 1) {
+        std::vector<ballot_request_type> requests(ballots, {voter_idx, vote, voter_secret_key});
+        std::vector<std::vector<std::uint8_t>> proof_blobs;
+        std::vector<std::vector<std::uint8_t>> pinput_blobs;
+        std::vector<std::vector<std::uint8_t>> ct_blobs;
+        std::vector<std::vector<std::uint8_t>> sn_blobs;
+
+        start = std::chrono::high_resolution_clock::now();
+        generate_votes_batch(session, requests, proof_blobs, pinput_blobs, ct_blobs, sn_blobs, workers, prover_threads);
+        duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
+        std::cout << "Batch Vote Phase Time_execution: " << duration.count() << "ms, "
+                  << 1000.0 * ballots / std::max<std::chrono::milliseconds::rep>(duration.count(), 1)
+                  << " ballots per second" << std::endl;
+        return;
+    }
+
+    for (std::size_t i = 0; i < ballots; ++i) {
+        start = std::chrono::high_resolution_clock::now();
+        session.cast_vote(voter_idx, vote, voter_secret_key, proof_blob, pinput_blob, ct_blob, sn_blob);
+        duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
+        std::cout << "Vote Phase Time_execution: " << duration.count() << "ms" << std::endl;
+    }
+}
+
+void benchmark_vote_verify_phase(std::size_t tree_depth, std::size_t ballots, std::size_t workers,
+                                 std::size_t prover_threads) {
+    logln("Reading data");
+    mapped_file proving_key("r1cs_proving_key.bin");
+    mapped_file verification_key("r1cs_verification_key.bin");
+    mapped_file public_key("public_key.bin");
+    auto voter_secret_key = read_obj("voter_secret_key.bin");
+    mapped_file eid("eid.bin");
+    mapped_file rt("rt.bin");
+    auto merkle_tree = read_obj("merkle_tree.bin");
+
+    const std::size_t eid_bits = 64;
+    const std::size_t voter_idx = 0;
+    const std::size_t vote = 0;
+
+    logln("Casting ballots to verify");
+    prover_session session(tree_depth, eid_bits, merkle_tree, rt, eid, public_key, proving_key, verification_key);
+    std::vector<ballot_request_type> requests(ballots, {voter_idx, vote, voter_secret_key});
+    std::vector<std::vector<std::uint8_t>> proof_blobs;
+    std::vector<std::vector<std::uint8_t>> pinput_blobs;
+    std::vector<std::vector<std::uint8_t>> ct_blobs;
+    std::vector<std::vector<std::uint8_t>> sn_blobs;
+    generate_votes_batch(session, requests, proof_blobs, pinput_blobs, ct_blobs, sn_blobs, workers, prover_threads);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    auto verdicts = process_encrypted_input_mode_vote_verify_phase(proof_blobs, pinput_blobs, ct_blobs, eid, rt,
+                                                                   public_key, verification_key, workers);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
+    BOOST_ASSERT_MSG(std::all_of(verdicts.begin(), verdicts.end(), [](bool b){return b;}),
+                     "Honestly cast ballot failed verification!");
+    std::cout << "Vote Verify Phase Time_execution: " << duration.count() << "ms, "
+              << 1000.0 * ballots / std::max<std::chrono::milliseconds::rep>(duration.count(), 1)
+              << " ballots per second" << std::endl;
+}
+
+void benchmark_elgamal_keygen_phase(std::size_t rounds) {
+    logln("Reading data");
+    mapped_file proving_key("r1cs_proving_key.bin");
+    mapped_file verification_key("r1cs_verification_key.bin");
+
+    std::vector<std::uint8_t> public_key_blob;
+    std::vector<std::uint8_t> secret_key_blob;
+    std::vector<std::uint8_t> verification_key_blob;
+
+    for (std::size_t i = 0; i < rounds; ++i) {
+        auto start = std::chrono::high_resolution_clock::now();
+        process_encrypted_input_mode_init_admin_phase_generate_elgamal_keys(
+                proving_key, verification_key, public_key_blob, secret_key_blob, verification_key_blob);
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - start);
+        std::cout << "El-Gamal Keygen Phase Time_execution: " << duration.count() << "ms" << std::endl;
+    }
 }
 
 int main(int argc, char *argv[]) {
     boost::program_options::options_description desc(
             "Vote Phase benchmarking");
     desc.add_options()
-    ("tree-depth", boost::program_options::value<std::size_t>()->default_value(2), "Depth of Merkle tree built upon participants' public keys.");
+    ("tree-depth", boost::program_options::value<std::size_t>()->default_value(2), "Depth of Merkle tree built upon participants' public keys.")
+    ("ballots", boost::program_options::value<std::size_t>()->default_value(1), "Number of ballots cast within one prover session, or of election key pairs generated by elgamal_keygen.")
+    ("threads", boost::program_options::value<std::size_t>()->default_value(0), "Number of prover threads of every ballot, 0 uses all cores, shared among the workers (MULTICORE builds only).")
+    ("workers", boost::program_options::value<std::size_t>()->default_value(1), "Number of ballots proved concurrently, values above 1 cast the ballots as one batch.")
+    ("crs-cache", boost::program_options::value<std::size_t>()->default_value(crs_cache::default_capacity), "Number of deserialized CRS kept in memory, 0 deserializes the CRS on every use.")
+    ("crs-store", boost::program_options::value<std::string>()->default_value(""), "Directory of the CRS generated for every circuit shape, reused by the later runs. Empty, the default, keeps the CRS in memory only.")
+    ("merkle-tree-format", boost::program_options::value<std::string>()->default_value("dense"), "Format of the generated Merkle tree, dense or sparse.")
+    ("phase", boost::program_options::value<std::string>()->default_value("vote"), "Benchmarked phase, allowed values:\n\t - vote (encrypt ballots and generate proofs),\n\t - vote_verify (verify the cast ballots on workers threads),\n\t - elgamal_keygen (generate election El-Gamal keys on the existing CRS),\n\t - test (run the self checks, then cast and verify one ballot).");
 
     boost::program_options::variables_map vm;
     boost::program_options::store(boost::program_options::command_line_parser(argc, argv).options(desc).run(), vm);
     boost::program_options::notify(vm);
 
     std::size_t tree_depth = vm["tree-depth"].as<std::size_t>();
+    std::size_t ballots = vm["ballots"].as<std::size_t>();
+    set_prover_threads(vm["threads"].as<std::size_t>());
 
     std::cout << "tree depth = " << tree_depth <<std::endl;
 
+    crs_cache::set_capacity(vm["crs-cache"].as<std::size_t>());
+    crs_store::set_directory(vm["crs-store"].as<std::string>());
+
+    if (vm["phase"].as<std::string>() == "test") {
+        test();
+        return 0;
+    }
+
+    const std::string &format_name = vm["merkle-tree-format"].as<std::string>();
+    BOOST_ASSERT_MSG(format_name == "dense" || format_name == "sparse", "Unknown Merkle tree format!");
+    merkle_tree_format format = format_name == "sparse" ? merkle_tree_format::sparse : merkle_tree_format::dense;
+
     std::cout << "Checking if test files exist" << std::endl;
     std::vector<bool> files_exist {
         std::filesystem::exists("r1cs_proving_key.bin"),
@@ -553,11 +927,23 @@ int main(int argc, char *argv[]) {
     if(std::all_of(files_exist.begin(), files_exist.end(), [](bool b){return b;})) {
         std::cout << "Setup already exists, skipping" <<std::endl;
     } else {
-        generate_test_data(tree_depth);
+        generate_test_data(tree_depth, format);
+    }
+
+    if (vm["phase"].as<std::string>() == "elgamal_keygen") {
+        std::cout << "Benchmarking El-Gamal keygen phase" <<std::endl;
+        benchmark_elgamal_keygen_phase(ballots);
+        return 0;
+    }
+
+    if (vm["phase"].as<std::string>() == "vote_verify") {
+        std::cout << "Benchmarking vote verify phase" <<std::endl;
+        benchmark_vote_verify_phase(tree_depth, ballots, vm["workers"].as<std::size_t>(), vm["threads"].as<std::size_t>());
+        return 0;
     }
 
     std::cout << "Benchmarking vote phase" <<std::endl;
-    benchmark_vote_pahse(tree_depth);
+    benchmark_vote_pahse(tree_depth, ballots, vm["workers"].as<std::size_t>(), vm["threads"].as<std::size_t>());
 /*
     srand_once();
     boost::program_options::options_description desc(
@@ -60,6 +60,14 @@ std::vector<std::vector<std::uint8_t>> super_buffer_to_blobs(const buffer<buffer
 }
 
 extern "C" {
+void set_crs_cache_capacity(std::size_t capacity) {
+    crs_cache::set_capacity(capacity);
+}
+
+void set_crs_store_capacity(std::size_t capacity) {
+    crs_store::set_capacity(capacity);
+}
+
 void generate_voter_keypair(buffer<char> *const voter_pk_out, buffer<char> *const voter_sk_out) {
     std::vector<std::uint8_t> voter_pk_blob;
     std::vector<std::uint8_t> voter_sk_blob;
@@ -94,10 +102,31 @@ void admin_keygen(std::size_t tree_depth, std::size_t eid_bits,
     *verification_key_out = blob_to_buffer(verification_key_blob);
 }
 
+void admin_elgamal_keygen(const buffer<char> *const r1cs_proving_key_buffer,
+                          const buffer<char> *const r1cs_verification_key_buffer,
+                          buffer<char> *const public_key_out, buffer<char> *const secret_key_out,
+                          buffer<char> *const verification_key_out) {
+    std::vector<std::uint8_t> public_key_blob;
+    std::vector<std::uint8_t> secret_key_blob;
+    std::vector<std::uint8_t> verification_key_blob;
+
+    auto r1cs_proving_key_blob = buffer_to_blob(r1cs_proving_key_buffer);
+    auto r1cs_verification_key_blob = buffer_to_blob(r1cs_verification_key_buffer);
+
+    process_encrypted_input_mode_init_admin_phase_generate_elgamal_keys(
+            r1cs_proving_key_blob, r1cs_verification_key_blob,
+            public_key_blob, secret_key_blob,
+            verification_key_blob);
+
+    *public_key_out = blob_to_buffer(public_key_blob);
+    *secret_key_out = blob_to_buffer(secret_key_blob);
+    *verification_key_out = blob_to_buffer(verification_key_blob);
+}
+
 void init_election(std::size_t tree_depth, std::size_t eid_bits,
                     const buffer<buffer<char> *const> *const public_keys_super_buffer,
                     buffer<char> *const eid_out, buffer<char> *const rt_out,
-                    buffer<char> *const merkle_tree_out) {
+                    buffer<char> *const merkle_tree_out, std::size_t merkle_tree_format_id) {
     std::vector<std::uint8_t> eid_blob;
     std::vector<std::uint8_t> rt_blob;
     std::vector<std::uint8_t> merkle_tree_blob;
@@ -108,13 +137,29 @@ void init_election(std::size_t tree_depth, std::size_t eid_bits,
     process_encrypted_input_mode_init_admin_phase_generate_data(
             tree_depth, eid_bits, public_keys_blobs,
             eid_blob,
-            rt_blob, merkle_tree_blob);
+            rt_blob, merkle_tree_blob, 0, static_cast<merkle_tree_format>(merkle_tree_format_id));
 
     *eid_out = blob_to_buffer(eid_blob);
     *rt_out = blob_to_buffer(rt_blob);
     *merkle_tree_out = blob_to_buffer(merkle_tree_blob);
 }
 
+void register_voter(std::size_t tree_depth, std::size_t voter_idx, const buffer<char> *const merkle_tree_buffer,
+                    const buffer<char> *const public_key_buffer, buffer<char> *const merkle_tree_out,
+                    buffer<char> *const rt_out, buffer<char> *const delta_out) {
+    std::vector<std::uint8_t> rt_blob;
+    std::vector<std::uint8_t> delta_blob;
+
+    auto merkle_tree_blob = buffer_to_blob(merkle_tree_buffer);
+    auto public_key_blob = buffer_to_blob(public_key_buffer);
+
+    update_merkle_tree_leaf(tree_depth, merkle_tree_blob, voter_idx, public_key_blob, rt_blob, delta_blob);
+
+    *merkle_tree_out = blob_to_buffer(merkle_tree_blob);
+    *rt_out = blob_to_buffer(rt_blob);
+    *delta_out = blob_to_buffer(delta_blob);
+}
+
 void generate_vote(std::size_t tree_depth, std::size_t eid_bits, std::size_t voter_idx, std::size_t vote,
                    const buffer<char> *const merkle_tree_buffer,
                    const buffer<char> *const rt_buffer, const buffer<char> *const eid_buffer,
@@ -122,7 +167,7 @@ void generate_vote(std::size_t tree_depth, std::size_t eid_bits, std::size_t vot
                    const buffer<char> *const r1cs_proving_key_buffer,
                    const buffer<char> *const r1cs_verification_key_buffer, buffer<char> *const proof_buffer_out,
                    buffer<char> *const pinput_buffer_out, buffer<char> *const ct_buffer_out,
-                   buffer<char> *const sn_buffer_out) {
+                   buffer<char> *const sn_buffer_out, std::size_t check_level, std::size_t threads) {
 
     std::vector<std::uint8_t> proof_blob_out;
     std::vector<std::uint8_t> pinput_blob_out;
@@ -143,8 +188,55 @@ void generate_vote(std::size_t tree_depth, std::size_t eid_bits, std::size_t vot
 
     logln("Finished conversion of merkle_tree,rt,eid,sk,pk_eid,proving_key,verification_key from buffer to blob");
 
+    set_prover_threads(threads);
+
     process_encrypted_input_mode_vote_phase(tree_depth, eid_bits, voter_idx, vote, merkle_tree_blob, rt_blob, eid_blob, sk_blob, pk_eid_blob, proving_key_blob, verification_key_blob,
-                                            proof_blob_out, pinput_blob_out, ct_blob_out, sn_blob_out);
+                                            proof_blob_out, pinput_blob_out, ct_blob_out, sn_blob_out,
+                                            static_cast<witness_check_level>(check_level));
+
+    *proof_buffer_out = blob_to_buffer(proof_blob_out);
+    *pinput_buffer_out = blob_to_buffer(pinput_blob_out);
+    *ct_buffer_out = blob_to_buffer(ct_blob_out);
+    *sn_buffer_out = blob_to_buffer(sn_blob_out);
+}
+
+void voter_copath(std::size_t tree_depth, std::size_t voter_idx, const buffer<char> *const merkle_tree_buffer,
+                  buffer<char> *const copath_buffer_out) {
+    auto merkle_tree_blob = buffer_to_blob(merkle_tree_buffer);
+    *copath_buffer_out = blob_to_buffer(extract_copath(tree_depth, merkle_tree_blob, voter_idx));
+}
+
+void generate_vote_from_copath(std::size_t tree_depth, std::size_t eid_bits, std::size_t voter_idx, std::size_t vote,
+                               const buffer<char> *const copath_buffer,
+                               const buffer<char> *const rt_buffer, const buffer<char> *const eid_buffer,
+                               const buffer<char> *const sk_buffer, const buffer<char> *const pk_eid_buffer,
+                               const buffer<char> *const r1cs_proving_key_buffer,
+                               const buffer<char> *const r1cs_verification_key_buffer,
+                               buffer<char> *const proof_buffer_out, buffer<char> *const pinput_buffer_out,
+                               buffer<char> *const ct_buffer_out, buffer<char> *const sn_buffer_out,
+                               std::size_t check_level, std::size_t threads) {
+
+    std::vector<std::uint8_t> proof_blob_out;
+    std::vector<std::uint8_t> pinput_blob_out;
+    std::vector<std::uint8_t> ct_blob_out;
+    std::vector<std::uint8_t> sn_blob_out;
+
+    auto copath_blob = buffer_to_blob(copath_buffer);
+    auto rt_blob = buffer_to_blob(rt_buffer);
+    auto eid_blob = buffer_to_blob(eid_buffer);
+    auto sk_blob = buffer_to_blob(sk_buffer);
+    auto pk_eid_blob = buffer_to_blob(pk_eid_buffer);
+    auto proving_key_blob = buffer_to_blob(r1cs_proving_key_buffer);
+    auto verification_key_blob = buffer_to_blob(r1cs_verification_key_buffer);
+
+    logln("Finished conversion of copath,rt,eid,sk,pk_eid,proving_key,verification_key from buffer to blob");
+
+    set_prover_threads(threads);
+
+    process_encrypted_input_mode_vote_phase_copath(tree_depth, eid_bits, voter_idx, vote, copath_blob, rt_blob, eid_blob,
+                                                   sk_blob, pk_eid_blob, proving_key_blob, verification_key_blob,
+                                                   proof_blob_out, pinput_blob_out, ct_blob_out, sn_blob_out,
+                                                   static_cast<witness_check_level>(check_level));
 
     *proof_buffer_out = blob_to_buffer(proof_blob_out);
     *pinput_buffer_out = blob_to_buffer(pinput_blob_out);
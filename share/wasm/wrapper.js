@@ -76,6 +76,25 @@ function freeSuperBuffer(super_buff_ptr) {
 
 
 
+/**
+ * Number of deserialized CRS kept in memory, 0 drops them and deserializes the CRS on every call.
+ * 
+ * @param {number} capacity 
+ */
+exports.set_crs_cache_capacity = function(capacity) {
+    cli._set_crs_cache_capacity(capacity);
+}
+
+/**
+ * Number of CRS generated by admin_keygen kept for elections of the same shape, 0 (the default) drops them and
+ * generates the CRS on every call.
+ * 
+ * @param {number} capacity 
+ */
+exports.set_crs_store_capacity = function(capacity) {
+    cli._set_crs_store_capacity(capacity);
+}
+
 /**
  * @typedef {Object} VoterKeypair
  * @property {Uint8Array} public_key - The X Coordinate
@@ -114,7 +133,6 @@ const eid_len = 64;
 
 /**
  * @param {number} tree_depth
- * @param {number} eid_bits
  * 
  * @returns {AdminKeys}
  */
@@ -150,6 +168,53 @@ exports.admin_keygen = function (tree_depth) {
     };
 }
 
+/**
+ * 
+ * @typedef {Object} ElectionKeys
+ * @property {Uint8Array} public_key
+ * @property {Uint8Array} secret_key
+ * @property {Uint8Array} verification_key
+ */
+
+/**
+ * Generates fresh El-Gamal keys of an election on the CRS of admin_keygen, without generating a new CRS.
+ * 
+ * @param {Uint8Array} r1cs_proving_key
+ * @param {Uint8Array} r1cs_verification_key
+ * 
+ * @returns {ElectionKeys}
+ */
+exports.admin_elgamal_keygen = function (r1cs_proving_key, r1cs_verification_key) {
+    r1cs_proving_key_buffer = Uint8ArrayToBufferPtr(r1cs_proving_key);
+    r1cs_verification_key_buffer = Uint8ArrayToBufferPtr(r1cs_verification_key);
+
+    public_key_bptr = cli._malloc(8);
+    secret_key_bptr = cli._malloc(8);
+    verification_key_bptr = cli._malloc(8);
+
+    cli._admin_elgamal_keygen(r1cs_proving_key_buffer, r1cs_verification_key_buffer,
+                              public_key_bptr, secret_key_bptr, verification_key_bptr);
+
+    public_key_blob = BufferPtrToUint8ArrayAndFree(public_key_bptr);
+    secret_key_blob = BufferPtrToUint8ArrayAndFree(secret_key_bptr);
+    verification_key_blob = BufferPtrToUint8ArrayAndFree(verification_key_bptr);
+
+    cli._free(public_key_bptr);
+    cli._free(secret_key_bptr);
+    cli._free(verification_key_bptr);
+
+    freeBuffer(r1cs_proving_key_buffer);
+    cli._free(r1cs_proving_key_buffer);
+    freeBuffer(r1cs_verification_key_buffer);
+    cli._free(r1cs_verification_key_buffer);
+
+    return {
+        public_key: public_key_blob,
+        secret_key: secret_key_blob,
+        verification_key: verification_key_blob,
+    };
+}
+
 /**
  * 
  * @typedef {Object} ElectionConfig
@@ -161,10 +226,11 @@ exports.admin_keygen = function (tree_depth) {
 /**
  * @param {number} tree_depth
  * @param {Uint8Array[]} public_keys
+ * @param {number} merkle_tree_format 0 - dense, every node of the full tree; 1 - sparse, sized by the number of public keys
  * 
  * @returns {ElectionConfig}
  */
- exports.init_election = function (tree_depth, public_keys) {
+ exports.init_election = function (tree_depth, public_keys, merkle_tree_format = 0) {
     public_keys_super_buffer = Uint8ArrayArrayToSuperBufferPtr(public_keys);
     
     eid_bptr = cli._malloc(8);
@@ -173,7 +239,7 @@ exports.admin_keygen = function (tree_depth) {
     
 
     cli._init_election(tree_depth, eid_len, public_keys_super_buffer,
-                       eid_bptr, rt_bptr, merkle_tree_bptr);
+                       eid_bptr, rt_bptr, merkle_tree_bptr, merkle_tree_format);
     
     eid_blob = BufferPtrToUint8ArrayAndFree(eid_bptr);
     rt_blob = BufferPtrToUint8ArrayAndFree(rt_bptr);
@@ -192,6 +258,54 @@ exports.admin_keygen = function (tree_depth) {
     };
 }
 
+/**
+ * 
+ * @typedef {Object} RegistrationUpdate
+ * @property {Uint8Array} rt
+ * @property {Uint8Array} merkle_tree
+ * @property {Uint8Array} delta Updated path, to be applied by replicas of the tree
+ */
+
+/**
+ * Puts the public key at voter_index of the tree, rehashing only the path of the leaf.
+ * 
+ * @param {number} tree_depth
+ * @param {number} voter_index
+ * @param {Uint8Array} merkle_tree
+ * @param {Uint8Array} public_key
+ * 
+ * @returns {RegistrationUpdate}
+ */
+exports.register_voter = function (tree_depth, voter_index, merkle_tree, public_key) {
+    merkle_tree_buffer = Uint8ArrayToBufferPtr(merkle_tree);
+    public_key_buffer = Uint8ArrayToBufferPtr(public_key);
+
+    merkle_tree_bptr = cli._malloc(8);
+    rt_bptr = cli._malloc(8);
+    delta_bptr = cli._malloc(8);
+
+    cli._register_voter(tree_depth, voter_index, merkle_tree_buffer, public_key_buffer,
+                        merkle_tree_bptr, rt_bptr, delta_bptr);
+
+    merkle_tree_blob = BufferPtrToUint8ArrayAndFree(merkle_tree_bptr);
+    rt_blob = BufferPtrToUint8ArrayAndFree(rt_bptr);
+    delta_blob = BufferPtrToUint8ArrayAndFree(delta_bptr);
+
+    freeBuffer(merkle_tree_buffer);
+    cli._free(merkle_tree_buffer);
+    freeBuffer(public_key_buffer);
+    cli._free(public_key_buffer);
+    cli._free(merkle_tree_bptr);
+    cli._free(rt_bptr);
+    cli._free(delta_bptr);
+
+    return {
+        rt: rt_blob,
+        merkle_tree: merkle_tree_blob,
+        delta: delta_blob
+    };
+}
+
 /**
  * @typedef {Object} VoteData
  * @property {Uint8Array} proof
@@ -212,11 +326,13 @@ exports.admin_keygen = function (tree_depth) {
  * @param {Uint8Array} pk_eid 
  * @param {Uint8Array} r1cs_proving_key 
  * @param {Uint8Array} r1cs_verification_key 
+ * @param {number} check_level Witness checks while proving: 0 - none, 1 - final only, 2 - after every step
+ * @param {number} threads Prover threads, 0 - one per core (has effect only in MULTICORE builds)
  * @returns {VoteData}
  */
 exports.generate_vote = function (tree_depth, voter_index, vote, merkle_tree,
               rt, eid, sk, pk_eid, r1cs_proving_key,
-              r1cs_verification_key) {
+              r1cs_verification_key, check_level = 1, threads = 0) {
     merkle_tree_buffer = Uint8ArrayToBufferPtr(merkle_tree);
     rt_buffer = Uint8ArrayToBufferPtr(rt);
     eid_buffer = Uint8ArrayToBufferPtr(eid);
@@ -235,7 +351,7 @@ exports.generate_vote = function (tree_depth, voter_index, vote, merkle_tree,
         rt_buffer, eid_buffer, sk_buffer, pk_eid_buffer,
         r1cs_proving_key_buffer, r1cs_verification_key_buffer,
         proof_buffer_out, pinput_buffer_out, ct_buffer_out,
-        sn_buffer_out);
+        sn_buffer_out, check_level, threads);
     
     proof_blob = BufferPtrToUint8ArrayAndFree(proof_buffer_out);
     pinput_blob = BufferPtrToUint8ArrayAndFree(pinput_buffer_out);
@@ -270,6 +386,100 @@ exports.generate_vote = function (tree_depth, voter_index, vote, merkle_tree,
     }
 }
 
+/**
+ * 
+ * @param {number} tree_depth 
+ * @param {number} voter_index 
+ * @param {Uint8Array} merkle_tree 
+ * @returns {Uint8Array} Co-path of the voter, to be passed to generate_vote_from_copath
+ */
+exports.voter_copath = function (tree_depth, voter_index, merkle_tree) {
+    merkle_tree_buffer = Uint8ArrayToBufferPtr(merkle_tree);
+    copath_buffer_out = cli._malloc(8);
+
+    cli._voter_copath(tree_depth, voter_index, merkle_tree_buffer, copath_buffer_out);
+
+    copath_blob = BufferPtrToUint8ArrayAndFree(copath_buffer_out);
+    cli._free(copath_buffer_out);
+
+    freeBuffer(merkle_tree_buffer);
+    cli._free(merkle_tree_buffer);
+
+    return copath_blob;
+}
+
+/**
+ * Same as generate_vote, but takes the voter's co-path instead of the whole Merkle tree.
+ * 
+ * @param {number} tree_depth 
+ * @param {number} voter_index 
+ * @param {number} vote 
+ * @param {Uint8Array} copath 
+ * @param {Uint8Array} rt 
+ * @param {Uint8Array} eid 
+ * @param {Uint8Array} sk 
+ * @param {Uint8Array} pk_eid 
+ * @param {Uint8Array} r1cs_proving_key 
+ * @param {Uint8Array} r1cs_verification_key 
+ * @param {number} check_level Witness checks while proving: 0 - none, 1 - final only, 2 - after every step
+ * @param {number} threads Prover threads, 0 - one per core (has effect only in MULTICORE builds)
+ * @returns {VoteData}
+ */
+exports.generate_vote_from_copath = function (tree_depth, voter_index, vote, copath,
+              rt, eid, sk, pk_eid, r1cs_proving_key,
+              r1cs_verification_key, check_level = 1, threads = 0) {
+    copath_buffer = Uint8ArrayToBufferPtr(copath);
+    rt_buffer = Uint8ArrayToBufferPtr(rt);
+    eid_buffer = Uint8ArrayToBufferPtr(eid);
+    sk_buffer = Uint8ArrayToBufferPtr(sk);
+    pk_eid_buffer = Uint8ArrayToBufferPtr(pk_eid);
+    r1cs_proving_key_buffer = Uint8ArrayToBufferPtr(r1cs_proving_key);
+    r1cs_verification_key_buffer = Uint8ArrayToBufferPtr(r1cs_verification_key);
+
+    proof_buffer_out = cli._malloc(8);
+    pinput_buffer_out = cli._malloc(8);
+    ct_buffer_out = cli._malloc(8);
+    sn_buffer_out = cli._malloc(8);
+
+    cli._generate_vote_from_copath(tree_depth, eid_len, voter_index, vote, copath_buffer,
+        rt_buffer, eid_buffer, sk_buffer, pk_eid_buffer,
+        r1cs_proving_key_buffer, r1cs_verification_key_buffer,
+        proof_buffer_out, pinput_buffer_out, ct_buffer_out,
+        sn_buffer_out, check_level, threads);
+
+    proof_blob = BufferPtrToUint8ArrayAndFree(proof_buffer_out);
+    pinput_blob = BufferPtrToUint8ArrayAndFree(pinput_buffer_out);
+    ct_blob = BufferPtrToUint8ArrayAndFree(ct_buffer_out);
+    sn_blob = BufferPtrToUint8ArrayAndFree(sn_buffer_out);
+
+    cli._free(proof_buffer_out);
+    cli._free(pinput_buffer_out);
+    cli._free(ct_buffer_out);
+    cli._free(sn_buffer_out);
+
+    freeBuffer(copath_buffer);
+    cli._free(copath_buffer);
+    freeBuffer(rt_buffer);
+    cli._free(rt_buffer);
+    freeBuffer(eid_buffer);
+    cli._free(eid_buffer);
+    freeBuffer(sk_buffer);
+    cli._free(sk_buffer);
+    freeBuffer(pk_eid_buffer);
+    cli._free(pk_eid_buffer);
+    freeBuffer(r1cs_proving_key_buffer);
+    cli._free(r1cs_proving_key_buffer);
+    freeBuffer(r1cs_verification_key_buffer);
+    cli._free(r1cs_verification_key_buffer);
+
+    return {
+        proof: proof_blob,
+        pinput: pinput_blob,
+        ct: ct_blob,
+        sn: sn_blob
+    }
+}
+
 /**
  * @typedef TallyData
  * 